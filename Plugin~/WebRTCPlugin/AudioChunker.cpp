@@ -0,0 +1,37 @@
+#include "pch.h"
+
+#include <cmath>
+
+#include "AudioChunker.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    void AudioChunker::FloatToS16(const float* __restrict src, size_t size, int16_t* __restrict dst)
+    {
+        // Same as webrtc::FloatToS16, the samples are scaled by 32768, clamped,
+        // then rounded away from zero.
+        for (size_t i = 0; i < size; i++)
+        {
+            float v = src[i] * 32768.f;
+            v = std::min(v, 32767.f);
+            v = std::max(v, -32768.f);
+            dst[i] = static_cast<int16_t>(v + std::copysign(0.5f, v));
+        }
+    }
+
+    void AudioChunker::Configure(int sampleRate, size_t numChannels)
+    {
+        if (sampleRate_ == sampleRate && numChannels_ == numChannels)
+            return;
+        sampleRate_ = sampleRate;
+        numChannels_ = numChannels;
+        // eg.  80 for 8KHz and 160 for 16kHz
+        framesPerChunk_ = static_cast<size_t>(sampleRate / 100);
+        chunk_.assign(framesPerChunk_ * numChannels, 0);
+        filled_ = 0;
+    }
+
+} // end namespace webrtc
+} // end namespace unity
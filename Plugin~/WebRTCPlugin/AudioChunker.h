@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+namespace unity
+{
+namespace webrtc
+{
+    // Converts the float samples to 16bit and cuts them into the chunks of
+    // exactly 10 ms, which WebRTC expects. The samples are converted straight
+    // into the chunk buffer, so nothing is moved or allocated while pushing.
+    class AudioChunker
+    {
+    public:
+        // Converts |size| samples like webrtc::FloatToS16, without the branches
+        // so that the compiler vectorizes the loop.
+        static void FloatToS16(const float* __restrict src, size_t size, int16_t* __restrict dst);
+
+        // Drops the buffered samples when the format changes.
+        void Configure(int sampleRate, size_t numChannels);
+
+        // Calls |onChunk(const int16_t* data, size_t remainingFrames)| for each
+        // completed chunk. |remainingFrames| is the number of the frames of
+        // |data| which follow the chunk.
+        template<typename Callback>
+        void Push(const float* data, size_t numFrames, Callback&& onChunk)
+        {
+            const size_t chunkSamples = chunk_.size();
+            if (chunkSamples == 0)
+                return;
+            size_t samples = numFrames * numChannels_;
+            while (samples > 0)
+            {
+                const size_t count = std::min(samples, chunkSamples - filled_);
+                FloatToS16(data, count, chunk_.data() + filled_);
+                data += count;
+                samples -= count;
+                filled_ += count;
+                if (filled_ < chunkSamples)
+                    break;
+                filled_ = 0;
+                onChunk(static_cast<const int16_t*>(chunk_.data()), samples / numChannels_);
+            }
+        }
+
+        int sampleRate() const { return sampleRate_; }
+        size_t numChannels() const { return numChannels_; }
+        size_t framesPerChunk() const { return framesPerChunk_; }
+        // The number of the frames which wait for the next chunk.
+        size_t bufferedFrames() const { return numChannels_ ? filled_ / numChannels_ : 0; }
+
+    private:
+        std::vector<int16_t> chunk_;
+        size_t filled_ = 0;
+        int sampleRate_ = 0;
+        size_t numChannels_ = 0;
+        size_t framesPerChunk_ = 0;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
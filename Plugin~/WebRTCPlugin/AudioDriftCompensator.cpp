@@ -0,0 +1,50 @@
+#include "pch.h"
+
+#include "AudioDriftCompensator.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    // The smoothing of the buffer level for each read.
+    static constexpr double kLevelSmoothing = 0.05;
+    // The stretch per second of the error of the buffer level.
+    static constexpr double kProportionalGain = 0.1;
+    // The change of the estimated drift per second per second of the error.
+    static constexpr double kIntegralGain = 0.01;
+
+    void AudioDriftCompensator::Reset(size_t channels, int sampleRate)
+    {
+        RTC_DCHECK_LE(channels, kMaxChannels);
+        if (channels_ != channels || sampleRate_ != sampleRate)
+        {
+            // The drift is kept while the clocks are the same.
+            channels_ = channels;
+            sampleRate_ = sampleRate;
+            drift_ = 0.0;
+        }
+        ratio_ = 1.0 + drift_;
+        level_ = -1.0;
+        // The first two input frames are read before the first output frame.
+        phase_ = 2.0;
+        std::fill(previous_, previous_ + kMaxChannels, 0.f);
+        std::fill(current_, current_ + kMaxChannels, 0.f);
+    }
+
+    void AudioDriftCompensator::Update(size_t bufferedFrames, size_t outputFrames, size_t targetFrames)
+    {
+        const double buffered = static_cast<double>(bufferedFrames);
+        level_ = level_ < 0.0 ? buffered : level_ + kLevelSmoothing * (buffered - level_);
+
+        // The error and the interval in seconds.
+        const double error = (level_ - static_cast<double>(targetFrames)) / sampleRate_;
+        const double interval = static_cast<double>(outputFrames) / sampleRate_;
+
+        // The integral of the error converges to the drift of the clocks.
+        drift_ = std::min(std::max(drift_ + kIntegralGain * error * interval, -kMaxDrift), kMaxDrift);
+        const double correction = drift_ + kProportionalGain * error;
+        ratio_ = 1.0 + std::min(std::max(correction, -kMaxCorrection), kMaxCorrection);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include <common_audio/include/audio_util.h>
+
+namespace unity
+{
+namespace webrtc
+{
+    // Holds the buffered audio at the target level while the clock of the
+    // producer drifts from the clock of the consumer. The consumer stretches
+    // the audio by the small ratio with the linear interpolation. The ratio
+    // follows the estimated drift plus the correction of the buffer level.
+    class AudioDriftCompensator
+    {
+    public:
+        static constexpr size_t kMaxChannels = 8;
+        // The limit of the estimated drift.
+        static constexpr double kMaxDrift = 0.002;
+        // The limit of the stretch of the audio, including the drift.
+        static constexpr double kMaxCorrection = 0.005;
+
+        // Starts with the empty history.
+        void Reset(size_t channels, int sampleRate);
+
+        // Updates the ratio for the next |outputFrames|. |bufferedFrames| is
+        // the level of the buffer before the read.
+        void Update(size_t bufferedFrames, size_t outputFrames, size_t targetFrames);
+
+        // Writes |outputFrames| interleaved frames into |output|. |pull(int16_t* data, size_t frames)|
+        // reads the input frames and returns the number of the read frames.
+        // Returns the number of the written frames, less than |outputFrames| if
+        // the input runs out.
+        template<typename Pull>
+        size_t Process(float* output, size_t outputFrames, Pull&& pull)
+        {
+            int16_t block[kBlockSamples];
+            const size_t blockCapacity = kBlockSamples / channels_;
+            size_t blockFrames = 0;
+            size_t blockIndex = 0;
+
+            // The number of the input frames which this call advances.
+            size_t needed = outputFrames > 0
+                ? static_cast<size_t>(std::floor(phase_ + static_cast<double>(outputFrames - 1) * ratio_))
+                : 0;
+
+            for (size_t i = 0; i < outputFrames; i++)
+            {
+                while (phase_ >= 1.0)
+                {
+                    phase_ -= 1.0;
+                    std::copy(current_, current_ + channels_, previous_);
+                    if (blockIndex == blockFrames)
+                    {
+                        blockFrames = pull(block, std::min(blockCapacity, std::max<size_t>(needed, 1)));
+                        blockIndex = 0;
+                        if (blockFrames == 0)
+                        {
+                            // Starts with the next input frame next time.
+                            phase_ = 1.0;
+                            return i;
+                        }
+                        needed -= std::min(needed, blockFrames);
+                    }
+                    const int16_t* frame = block + blockIndex * channels_;
+                    for (size_t c = 0; c < channels_; c++)
+                        current_[c] = ::webrtc::S16ToFloat(frame[c]);
+                    blockIndex++;
+                }
+                const float t = static_cast<float>(phase_);
+                for (size_t c = 0; c < channels_; c++)
+                    output[i * channels_ + c] = previous_[c] + (current_[c] - previous_[c]) * t;
+                phase_ += ratio_;
+            }
+            return outputFrames;
+        }
+
+        // The number of the input frames per output frame.
+        double ratio() const { return ratio_; }
+        // The estimated drift of the producer from the consumer. Positive when
+        // the producer is faster.
+        double drift() const { return drift_; }
+        // The smoothed level of the buffer in frames.
+        double level() const { return level_; }
+
+    private:
+        static constexpr size_t kBlockSamples = 512;
+
+        size_t channels_ = 0;
+        int sampleRate_ = 0;
+        double ratio_ = 1.0;
+        double drift_ = 0.0;
+        double level_ = -1.0;
+        double phase_ = 2.0;
+        float previous_[kMaxChannels] = {};
+        float current_[kMaxChannels] = {};
+    };
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,54 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "AudioRingBuffer.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    AudioRingBuffer::AudioRingBuffer(size_t capacity)
+        : buffer_(capacity)
+        , writeCount_(0)
+        , readCount_(0)
+    {
+        RTC_DCHECK(capacity);
+    }
+
+    size_t AudioRingBuffer::Write(const int16_t* data, size_t size)
+    {
+        const size_t writeCount = writeCount_.load(std::memory_order_relaxed);
+        const size_t readCount = readCount_.load(std::memory_order_acquire);
+        const size_t count = std::min(size, capacity() - (writeCount - readCount));
+        const size_t index = writeCount % capacity();
+        const size_t first = std::min(count, capacity() - index);
+        std::memcpy(buffer_.data() + index, data, first * sizeof(int16_t));
+        std::memcpy(buffer_.data(), data + first, (count - first) * sizeof(int16_t));
+        writeCount_.store(writeCount + count, std::memory_order_release);
+        return count;
+    }
+
+    size_t AudioRingBuffer::Read(int16_t* data, size_t size)
+    {
+        const size_t readCount = readCount_.load(std::memory_order_relaxed);
+        const size_t writeCount = writeCount_.load(std::memory_order_acquire);
+        const size_t count = std::min(size, writeCount - readCount);
+        const size_t index = readCount % capacity();
+        const size_t first = std::min(count, capacity() - index);
+        std::memcpy(data, buffer_.data() + index, first * sizeof(int16_t));
+        std::memcpy(data + first, buffer_.data(), (count - first) * sizeof(int16_t));
+        readCount_.store(readCount + count, std::memory_order_release);
+        return count;
+    }
+
+    size_t AudioRingBuffer::size() const
+    {
+        // The read count is loaded first, so it never exceeds the write count.
+        const size_t readCount = readCount_.load(std::memory_order_acquire);
+        return writeCount_.load(std::memory_order_acquire) - readCount;
+    }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+namespace unity
+{
+namespace webrtc
+{
+    // Wait-free ring of the samples from one producer thread to one consumer
+    // thread. Each thread only advances its own index, so neither of them
+    // takes a lock or waits for the other.
+    class AudioRingBuffer
+    {
+    public:
+        explicit AudioRingBuffer(size_t capacity);
+        AudioRingBuffer(const AudioRingBuffer&) = delete;
+        AudioRingBuffer& operator=(const AudioRingBuffer&) = delete;
+
+        // Called on the producer thread. Writes as many samples as fit and
+        // returns the number of the written samples.
+        size_t Write(const int16_t* data, size_t size);
+
+        // Called on the consumer thread. Returns the number of the read samples.
+        size_t Read(int16_t* data, size_t size);
+
+        // The number of the samples which can be read.
+        size_t size() const;
+        size_t capacity() const { return buffer_.size(); }
+
+    private:
+        std::vector<int16_t> buffer_;
+        // The total number of the written and read samples. The indices in
+        // |buffer_| are these modulo the capacity.
+        alignas(64) std::atomic<size_t> writeCount_;
+        alignas(64) std::atomic<size_t> readCount_;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,65 @@
+#include "pch.h"
+
+#include <algorithm>
+
+#include "AudioTickScheduler.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    constexpr int64_t AudioTickScheduler::kHistogramBoundsUs[];
+
+    AudioTickScheduler::AudioTickScheduler(TimeDelta period, int maxCatchUpTicks)
+        : period_(period)
+        , maxCatchUpTicks_(maxCatchUpTicks)
+        , deadline_(Timestamp::MinusInfinity())
+    {
+        RTC_DCHECK_GT(period_, TimeDelta::Zero());
+        RTC_DCHECK_GE(maxCatchUpTicks_, 0);
+    }
+
+    void AudioTickScheduler::Start(Timestamp now) { deadline_ = now; }
+
+    Timestamp AudioTickScheduler::OnTick(Timestamp now)
+    {
+        RTC_DCHECK(deadline_.IsFinite());
+
+        // The task queue never runs the task early, but the clocks may differ slightly.
+        const int64_t jitterUs = std::max<int64_t>((now - deadline_).us(), 0);
+        const int64_t* bound =
+            std::upper_bound(std::begin(kHistogramBoundsUs), std::end(kHistogramBoundsUs), jitterUs);
+        histogram_[bound - std::begin(kHistogramBoundsUs)].fetch_add(1, std::memory_order_relaxed);
+        ticks_.fetch_add(1, std::memory_order_relaxed);
+        if (jitterUs > maxJitterUs_.load(std::memory_order_relaxed))
+            maxJitterUs_.store(jitterUs, std::memory_order_relaxed);
+        if (jitterUs >= period_.us())
+            lateTicks_.fetch_add(1, std::memory_order_relaxed);
+
+        deadline_ += period_;
+
+        // Drop the overdue ticks beyond the limit of the catch up, and keep the phase of the deadlines.
+        const int64_t overdue = now < deadline_ ? 0 : (now - deadline_).us() / period_.us() + 1;
+        if (overdue > maxCatchUpTicks_)
+        {
+            const int64_t skipped = overdue - maxCatchUpTicks_;
+            deadline_ += period_ * skipped;
+            skippedTicks_.fetch_add(static_cast<uint64_t>(skipped), std::memory_order_relaxed);
+        }
+        return deadline_;
+    }
+
+    AudioTickStats AudioTickScheduler::GetStats() const
+    {
+        AudioTickStats stats;
+        stats.ticks = ticks_.load(std::memory_order_relaxed);
+        stats.lateTicks = lateTicks_.load(std::memory_order_relaxed);
+        stats.skippedTicks = skippedTicks_.load(std::memory_order_relaxed);
+        stats.maxJitterMs = maxJitterUs_.load(std::memory_order_relaxed) / 1000.0;
+        for (int i = 0; i < kAudioTickHistogramSize; i++)
+            stats.histogram[i] = histogram_[i].load(std::memory_order_relaxed);
+        return stats;
+    }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+
+#include <api/units/time_delta.h>
+#include <api/units/timestamp.h>
+
+namespace unity
+{
+namespace webrtc
+{
+    using namespace ::webrtc;
+
+    constexpr int kAudioTickHistogramSize = 8;
+
+    struct AudioTickStats
+    {
+        // The number of the ticks which have run.
+        uint64_t ticks;
+        // The number of the ticks which ran one period or more behind their deadline and were caught up.
+        uint64_t lateTicks;
+        // The number of the ticks which were dropped because the tick fell too far behind.
+        uint64_t skippedTicks;
+        // The largest delay of the tick from its deadline in milliseconds.
+        double maxJitterMs;
+        // The number of the ticks for each delay from the deadline.
+        // The upper bounds of the buckets are AudioTickScheduler::kHistogramBoundsUs, the last bucket has no bound.
+        uint64_t histogram[kAudioTickHistogramSize];
+    };
+
+    // Schedules the ticks of the audio device at the absolute deadlines
+    // start + n * period, so that the delay of one tick does not shift the
+    // following ticks. When the tick falls behind, the missed ticks run
+    // back to back until it catches up, but no more than |maxCatchUpTicks|,
+    // so that a long stall does not burst the audio into the receivers.
+    // The stats may be read from any thread.
+    class AudioTickScheduler
+    {
+    public:
+        static constexpr int64_t kHistogramBoundsUs[kAudioTickHistogramSize - 1] = { 250,  500,   1000, 2000,
+                                                                                     5000, 10000, 20000 };
+
+        AudioTickScheduler(TimeDelta period, int maxCatchUpTicks);
+
+        // Sets the deadline of the first tick.
+        void Start(Timestamp now);
+
+        // Called at the beginning of the tick. Returns the deadline of the next
+        // tick, which is not later than |now| while catching up. The caller
+        // derives the delay from the deadline after processing the tick.
+        Timestamp OnTick(Timestamp now);
+
+        AudioTickStats GetStats() const;
+
+    private:
+        const TimeDelta period_;
+        const int maxCatchUpTicks_;
+        Timestamp deadline_;
+
+        std::atomic<uint64_t> ticks_ { 0 };
+        std::atomic<uint64_t> lateTicks_ { 0 };
+        std::atomic<uint64_t> skippedTicks_ { 0 };
+        std::atomic<int64_t> maxJitterUs_ { 0 };
+        std::atomic<uint64_t> histogram_[kAudioTickHistogramSize] = {};
+    };
+
+} // end namespace webrtc
+} // end namespace unity
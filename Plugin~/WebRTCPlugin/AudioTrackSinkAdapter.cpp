@@ -1,7 +1,6 @@
 #include "pch.h"
 
 #include <audio/remix_resample.h>
-#include <common_audio/include/audio_util.h>
 
 #include "AudioTrackSinkAdapter.h"
 
@@ -9,12 +8,60 @@ namespace unity
 {
 namespace webrtc
 {
+    // The samples which are discarded at once on the audio thread of Unity.
+    static constexpr size_t kReadBlockSize = 256;
+
+    static size_t FormatChannels(uint64_t format) { return static_cast<size_t>((format >> 32) & 0xffff); }
+    static int32_t FormatSampleRate(uint64_t format) { return static_cast<int32_t>(format & 0xffffffff); }
+    static int32_t FormatTargetLatencyMs(uint64_t format) { return static_cast<int32_t>(format >> 48); }
+
+    AudioTrackSinkAdapter::PlayoutBuffer::PlayoutBuffer(uint64_t format, size_t capacity)
+        : format(format)
+        , ring(capacity)
+    {
+    }
+
     AudioTrackSinkAdapter::AudioTrackSinkAdapter()
-        : _buffer(nullptr)
+        : _writeBuffer(nullptr)
+        , _readFormat(0)
+        , _started(false)
+        , _requestedFormat(0)
+        , _pendingBuffer(nullptr)
+        , _retiredBuffer(nullptr)
+        , _targetLatencyMs(kDefaultTargetLatencyMs)
+        , _underrunCount(0)
+        , _overrunCount(0)
+        , _bufferedMs(0.0)
+        , _driftPpm(0.0)
+    {
+    }
+
+    AudioTrackSinkAdapter::~AudioTrackSinkAdapter()
+    {
+        delete _pendingBuffer.load();
+        delete _retiredBuffer.load();
+    }
+
+    uint64_t AudioTrackSinkAdapter::PackFormat(size_t channels, int32_t sampleRate, int32_t targetLatencyMs)
+    {
+        return static_cast<uint64_t>(targetLatencyMs) << 48 | static_cast<uint64_t>(channels & 0xffff) << 32 |
+            static_cast<uint32_t>(sampleRate);
+    }
+
+    AudioTrackSinkStats AudioTrackSinkAdapter::GetStats() const
     {
+        AudioTrackSinkStats stats;
+        stats.underruns = _underrunCount.load(std::memory_order_relaxed);
+        stats.overruns = _overrunCount.load(std::memory_order_relaxed);
+        stats.bufferedMs = _bufferedMs.load(std::memory_order_relaxed);
+        stats.driftPpm = _driftPpm.load(std::memory_order_relaxed);
+        return stats;
     }
 
-    AudioTrackSinkAdapter::~AudioTrackSinkAdapter() { WebRtc_FreeBuffer(_buffer); }
+    void AudioTrackSinkAdapter::SetTargetLatency(int32_t milliseconds)
+    {
+        _targetLatencyMs = std::min(std::max(milliseconds, 0), kMaxTargetLatencyMs);
+    }
 
     void AudioTrackSinkAdapter::OnData(
         const void* audio_data,
@@ -23,11 +70,36 @@ namespace webrtc
         size_t number_of_channels,
         size_t number_of_frames)
     {
-        std::lock_guard<std::mutex> lock(_mutex);
-
-        if (_buffer == nullptr)
+        // The ring which Unity has replaced is deleted here, not on the real-time
+        // thread. It may be the current ring if Unity has requested the other format.
+        PlayoutBuffer* retired = _retiredBuffer.exchange(nullptr, std::memory_order_acquire);
+        if (retired == _writeBuffer)
+            _writeBuffer = nullptr;
+        delete retired;
+
+        const uint64_t format = _requestedFormat.load(std::memory_order_acquire);
+        if (format == 0)
             return;
 
+        if (_writeBuffer == nullptr || _writeBuffer->format != format)
+        {
+            const size_t channels = FormatChannels(format);
+            const int32_t sampleRate = FormatSampleRate(format);
+
+            // keep it relatively short at 0.2s, or twice the target latency.
+            // The capacity is whole frames, so the ring never splits a frame.
+            const int64_t targetFrames = int64_t { sampleRate } * FormatTargetLatencyMs(format) / 1000;
+            const size_t frames = static_cast<size_t>(std::max<int64_t>(sampleRate / 5, targetFrames * 2));
+            _writeBuffer = new PlayoutBuffer(format, channels * frames);
+
+            // The previous ring has not been taken by Unity yet, so it is deleted here.
+            delete _pendingBuffer.exchange(_writeBuffer, std::memory_order_acq_rel);
+
+            // reset audio frame.
+            _frame.num_channels_ = channels;
+            _frame.sample_rate_hz_ = sampleRate;
+        }
+
         // note: AudioTrackSinkInterface::OnData method is passed audio data from
         // audio decoder directly, so we need to resample for expected format.
         // For example, when we use encoder/decoder which has monoural channel,
@@ -44,26 +116,9 @@ namespace webrtc
 
         size_t length = _frame.num_channels() * _frame.samples_per_channel();
 
-        WebRtc_WriteBuffer(_buffer, _frame.data(), length);
-    }
-
-    void AudioTrackSinkAdapter::ResizeBuffer(size_t channels, int32_t sampleRate, size_t length)
-    {
-        RTC_DCHECK(channels);
-        RTC_DCHECK(sampleRate);
-
-        // reallocate ring buffer, keep it relatively short at 0.2s
-        size_t bufferSize = static_cast<size_t>(static_cast<float>(channels) * static_cast<float>(sampleRate) * 0.2f);
-        if (_buffer != nullptr)
-            WebRtc_FreeBuffer(_buffer);
-        _buffer = WebRtc_CreateBuffer(bufferSize, sizeof(int16_t));
-
-        // reset audio frame.
-        _frame.num_channels_ = channels;
-        _frame.sample_rate_hz_ = sampleRate;
-
-        // reallocate temporary buffer.
-        _bufferIn.resize(length);
+        // The samples which don't fit are dropped like the previous ring buffer.
+        if (_writeBuffer->ring.Write(_frame.data(), length) < length)
+            _overrunCount++;
     }
 
     void AudioTrackSinkAdapter::ProcessAudio(float* data, size_t length, size_t channels, int32_t sampleRate)
@@ -75,20 +130,83 @@ namespace webrtc
 
         std::memset(data, 0, sizeof(float) * length);
 
-        std::lock_guard<std::mutex> lock(_mutex);
+        // Request the new ring when Unity changes channel count, sample rate or the target latency.
+        const uint64_t format = PackFormat(channels, sampleRate, _targetLatencyMs.load(std::memory_order_relaxed));
+        if (_readFormat != format)
+        {
+            _readFormat = format;
+            _started = false;
+            _requestedFormat.store(format, std::memory_order_release);
+        }
 
-        // Reallocate audio buffer when Unity changes channel count, sample rate,
-        // or data length.
-        if (_buffer == nullptr || _frame.num_channels_ != channels || _frame.sample_rate_hz_ != sampleRate ||
-            _bufferIn.size() != length)
+        if (PlayoutBuffer* buffer = _pendingBuffer.exchange(nullptr, std::memory_order_acq_rel))
         {
-            ResizeBuffer(channels, sampleRate, length);
+            // The ring for the older format is returned without being used.
+            std::unique_ptr<PlayoutBuffer> retired(buffer);
+            if (buffer->format == _readFormat)
+                _readBuffer.swap(retired);
+            // The slot is still occupied only when the format changes twice
+            // before the producer runs, then the ring is deleted here.
+            delete _retiredBuffer.exchange(retired.release(), std::memory_order_acq_rel);
         }
 
-        size_t readLength = WebRtc_ReadBuffer(_buffer, nullptr, _bufferIn.data(), length);
+        if (_readBuffer == nullptr || _readBuffer->format != _readFormat)
+            return;
+        if (channels > AudioDriftCompensator::kMaxChannels)
+            return;
+
+        AudioRingBuffer& ring = _readBuffer->ring;
+        const size_t frames = length / channels;
+        const size_t bufferedFrames = ring.size() / channels;
+
+        // The target is at least one read of Unity plus one chunk of WebRTC.
+        const size_t targetFrames = std::max(
+            static_cast<size_t>(int64_t { sampleRate } * FormatTargetLatencyMs(_readFormat) / 1000),
+            frames + static_cast<size_t>(sampleRate / 100));
+
+        if (!_started)
+        {
+            // Silence until the ring fills up to the target.
+            if (bufferedFrames < targetFrames)
+                return;
+            _started = true;
+            _compensator.Reset(channels, sampleRate);
+        }
+        else if (bufferedFrames == 0)
+        {
+            // The producer has stopped, so the ring fills up to the target again.
+            _underrunCount++;
+            _started = false;
+            return;
+        }
+        else if (bufferedFrames > targetFrames * 2)
+        {
+            // Too late to catch up by stretching, drop the audio down to the target.
+            int16_t block[kReadBlockSize];
+            const size_t blockFrames = kReadBlockSize / channels;
+            size_t excess = bufferedFrames - targetFrames;
+            while (excess > 0)
+            {
+                const size_t count = ring.Read(block, std::min(excess, blockFrames) * channels) / channels;
+                if (count == 0)
+                    break;
+                excess -= count;
+            }
+            _compensator.Reset(channels, sampleRate);
+        }
+
+        _compensator.Update(ring.size() / channels, frames, targetFrames);
+        const size_t written = _compensator.Process(
+            data,
+            frames,
+            [&ring, channels](int16_t* dst, size_t count) { return ring.Read(dst, count * channels) / channels; });
+
+        _bufferedMs.store(_compensator.level() * 1000.0 / sampleRate, std::memory_order_relaxed);
+        _driftPpm.store(_compensator.drift() * 1e6, std::memory_order_relaxed);
 
-        for (size_t i = 0; i < readLength; i++)
-            data[i] = webrtc::S16ToFloat(_bufferIn[i]);
+        // A late chunk is played as soon as it arrives, without the silence up to the target.
+        if (written < frames)
+            _underrunCount++;
     }
 } // end namespace webrtc
 } // end namespace unity
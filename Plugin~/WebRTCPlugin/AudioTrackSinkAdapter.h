@@ -1,11 +1,14 @@
 #pragma once
 
-#include <mutex>
+#include <atomic>
+#include <memory>
 
 #include <api/audio/audio_frame.h>
 #include <api/media_stream_interface.h>
 #include <common_audio/resampler/include/push_resampler.h>
-#include <common_audio/ring_buffer.h>
+
+#include "AudioDriftCompensator.h"
+#include "AudioRingBuffer.h"
 
 namespace unity
 {
@@ -13,6 +16,23 @@ namespace webrtc
 {
     using namespace ::webrtc;
 
+    struct AudioTrackSinkStats
+    {
+        // The number of the reads which could not fill the buffer of Unity.
+        uint64_t underruns;
+        // The number of the writes which did not fit in the ring.
+        uint64_t overruns;
+        // The smoothed level of the ring in milliseconds.
+        double bufferedMs;
+        // The estimated drift of the clock of WebRTC from the clock of Unity.
+        double driftPpm;
+    };
+
+    // Passes the remote audio from the audio thread of WebRTC to the audio
+    // thread of Unity through the wait-free ring, so that the real-time thread
+    // of Unity never takes a lock. The audio is stretched slightly to hold the
+    // level of the ring at the target latency, because the clocks of the
+    // threads drift apart.
     class AudioTrackSinkAdapter : public webrtc::AudioTrackSinkInterface
     {
     public:
@@ -28,15 +48,48 @@ namespace webrtc
 
         void ProcessAudio(float* data, size_t length, size_t channels, int32_t sampleRate);
 
+        AudioTrackSinkStats GetStats() const;
+
+        // The level of the ring which the playout holds.
+        void SetTargetLatency(int32_t milliseconds);
+
+        static constexpr int32_t kDefaultTargetLatencyMs = 20;
+        static constexpr int32_t kMaxTargetLatencyMs = 1000;
+
     private:
-        void ResizeBuffer(size_t channels, int32_t sampleRate, size_t length);
+        // The ring for the format which Unity requests.
+        struct PlayoutBuffer
+        {
+            PlayoutBuffer(uint64_t format, size_t capacity);
+            const uint64_t format;
+            AudioRingBuffer ring;
+        };
 
-        AudioFrame _frame;
-        std::mutex _mutex;
-        RingBuffer* _buffer;
-        std::vector<int16_t> _bufferIn;
+        // The target latency is a part of the format, because it decides the capacity of the ring.
+        static uint64_t PackFormat(size_t channels, int32_t sampleRate, int32_t targetLatencyMs);
 
+        // Used on the audio thread of WebRTC.
+        AudioFrame _frame;
         PushResampler<int16_t> _resampler;
+        PlayoutBuffer* _writeBuffer;
+
+        // Used on the audio thread of Unity.
+        std::unique_ptr<PlayoutBuffer> _readBuffer;
+        uint64_t _readFormat;
+        bool _started;
+        AudioDriftCompensator _compensator;
+
+        // The consumer requests the format, then the producer creates the ring
+        // and passes it through |_pendingBuffer|. The replaced ring is returned
+        // through |_retiredBuffer| and deleted by the producer.
+        std::atomic<uint64_t> _requestedFormat;
+        std::atomic<PlayoutBuffer*> _pendingBuffer;
+        std::atomic<PlayoutBuffer*> _retiredBuffer;
+        std::atomic<int32_t> _targetLatencyMs;
+        std::atomic<uint64_t> _underrunCount;
+        std::atomic<uint64_t> _overrunCount;
+        std::atomic<double> _bufferedMs;
+        std::atomic<double> _driftPpm;
     };
 } // end namespace webrtc
 } // end namespace unity
@@ -0,0 +1,26 @@
+#include "pch.h"
+
+#include "CaptureClock.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    CaptureClock::CaptureClock(Clock* clock)
+        : clock_(clock)
+        , ntpOffsetMs_(clock->CurrentNtpInMilliseconds() - clock->TimeInMilliseconds())
+    {
+    }
+
+    CaptureClock& CaptureClock::GetInstance()
+    {
+        static CaptureClock instance(Clock::GetRealTimeClock());
+        return instance;
+    }
+
+    Timestamp CaptureClock::CurrentTime() const { return clock_->CurrentTime(); }
+
+    int64_t CaptureClock::ToNtpTimeMs(Timestamp time) const { return time.ms() + ntpOffsetMs_; }
+
+} // end namespace webrtc
+} // end namespace unity
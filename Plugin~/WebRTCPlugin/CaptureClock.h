@@ -0,0 +1,38 @@
+#pragma once
+
+#include <system_wrappers/include/clock.h>
+
+namespace unity
+{
+namespace webrtc
+{
+    using namespace ::webrtc;
+
+    // The clock which the audio and the video track sources stamp the captured
+    // data with. The audio is passed in the time of rtc::TimeMillis, which WebRTC
+    // converts to the NTP time itself. Only the video frames are mapped through
+    // ToNtpTimeMs, whose offset to the NTP time is fixed at the construction.
+    // Thread-safe.
+    class CaptureClock
+    {
+    public:
+        explicit CaptureClock(Clock* clock);
+        CaptureClock(const CaptureClock&) = delete;
+        CaptureClock& operator=(const CaptureClock&) = delete;
+
+        // Shared by all track sources in the process.
+        static CaptureClock& GetInstance();
+
+        // The time in the same clock as rtc::TimeMicros.
+        Timestamp CurrentTime() const;
+
+        // Converts |time| in the clock of CurrentTime to the NTP time in milliseconds.
+        int64_t ToNtpTimeMs(Timestamp time) const;
+
+    private:
+        Clock* const clock_;
+        const int64_t ntpOffsetMs_;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
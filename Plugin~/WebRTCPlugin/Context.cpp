@@ -11,6 +11,7 @@
 #include "GraphicsDevice/GraphicsUtility.h"
 #include "GraphicsDevice/IGraphicsDevice.h"
 #include "MediaStreamObserver.h"
+#include "PerStreamAudioMixer.h"
 #include "UnityAudioDecoderFactory.h"
 #include "UnityAudioEncoderFactory.h"
 #include "UnityAudioTrackSource.h"
@@ -151,6 +152,7 @@ namespace webrtc
         : m_workerThread(rtc::Thread::CreateWithSocketServer())
         , m_signalingThread(rtc::Thread::CreateWithSocketServer())
         , m_taskQueueFactory(CreateDefaultTaskQueueFactory())
+        , m_schedulerTaskQueueFactory(std::make_unique<SchedulerTaskQueueFactory>())
     {
         m_workerThread->Start();
         m_signalingThread->Start();
@@ -169,6 +171,11 @@ namespace webrtc
         rtc::scoped_refptr<AudioEncoderFactory> audioEncoderFactory = CreateAudioEncoderFactory();
         rtc::scoped_refptr<AudioDecoderFactory> audioDecoderFactory = CreateAudioDecoderFactory();
 
+        // nullptr makes the default mixer.
+        rtc::scoped_refptr<AudioMixer> audioMixer;
+        if (dependencies.audioPlayoutMode == AudioPlayoutMode::kPerStream)
+            audioMixer = PerStreamAudioMixer::Create();
+
         m_peerConnectionFactory = CreatePeerConnectionFactory(
             m_workerThread.get(),
             m_workerThread.get(),
@@ -178,7 +185,7 @@ namespace webrtc
             audioDecoderFactory,
             std::move(videoEncoderFactory),
             std::move(videoDecoderFactory),
-            nullptr,
+            audioMixer,
             nullptr);
     }
 
@@ -228,7 +235,27 @@ namespace webrtc
 
     rtc::scoped_refptr<UnityVideoTrackSource> Context::CreateVideoSource()
     {
-        return rtc::make_ref_counted<UnityVideoTrackSource>(false, absl::nullopt, m_taskQueueFactory.get());
+        rtc::scoped_refptr<UnityVideoTrackSource> source =
+            rtc::make_ref_counted<UnityVideoTrackSource>(false, absl::nullopt, m_schedulerTaskQueueFactory.get());
+        std::lock_guard<std::mutex> lock(mutex);
+        m_mapVideoSourceId[source.get()] = source->id();
+        return source;
+    }
+
+    std::vector<uint64_t> Context::TakeRemovedVideoSourceIds()
+    {
+        std::vector<uint64_t> ids;
+        ids.swap(m_removedVideoSourceIds);
+        return ids;
+    }
+
+    void Context::OnRefPtrRemoved(const rtc::RefCountInterface* ptr)
+    {
+        auto it = m_mapVideoSourceId.find(ptr);
+        if (it == m_mapVideoSourceId.end())
+            return;
+        m_removedVideoSourceIds.push_back(it->second);
+        m_mapVideoSourceId.erase(it);
     }
 
     rtc::scoped_refptr<VideoTrackInterface>
@@ -6,6 +6,7 @@
 #include "DummyAudioDevice.h"
 #include "GraphicsDevice/IGraphicsDevice.h"
 #include "PeerConnectionObject.h"
+#include "SchedulerTaskQueueFactory.h"
 #include "UnityVideoRenderer.h"
 #include "UnityVideoTrackSource.h"
 
@@ -39,10 +40,20 @@ namespace webrtc
 
     class IGraphicsDevice;
     class ProfilerMarkerFactory;
+    // How DummyAudioDevice pulls the audio of the receive streams.
+    enum class AudioPlayoutMode
+    {
+        // Pulls each stream without mixing them, the audio is only passed to the sinks.
+        kPerStream,
+        // Mixes all streams with the default mixer of WebRTC and discards the result.
+        kMix,
+    };
+
     struct ContextDependencies
     {
         IGraphicsDevice* device;
         ProfilerMarkerFactory* profiler;
+        AudioPlayoutMode audioPlayoutMode = AudioPlayoutMode::kPerStream;
     };
 
     class Context;
@@ -90,12 +101,14 @@ namespace webrtc
         {
             std::lock_guard<std::mutex> lock(mutex);
             m_mapRefPtr.erase(refptr.get());
+            OnRefPtrRemoved(refptr.get());
         }
         template<typename T>
         void RemoveRefPtr(T* ptr)
         {
             std::lock_guard<std::mutex> lock(mutex);
             m_mapRefPtr.erase(ptr);
+            OnRefPtrRemoved(ptr);
         }
 
         // MediaStream
@@ -112,6 +125,9 @@ namespace webrtc
 
         // Video Source
         rtc::scoped_refptr<UnityVideoTrackSource> CreateVideoSource();
+        // Returns the ids of the video sources which were removed since the last call,
+        // so that the render thread releases their buffer pools. Called with |mutex| locked.
+        std::vector<uint64_t> TakeRemovedVideoSourceIds();
 
         // MediaStreamTrack
         rtc::scoped_refptr<VideoTrackInterface>
@@ -155,9 +171,13 @@ namespace webrtc
         std::mutex mutex;
 
     private:
+        void OnRefPtrRemoved(const rtc::RefCountInterface* ptr);
+
         std::unique_ptr<rtc::Thread> m_workerThread;
         std::unique_ptr<rtc::Thread> m_signalingThread;
         std::unique_ptr<TaskQueueFactory> m_taskQueueFactory;
+        // Shared by the frame schedulers of all video track sources.
+        std::unique_ptr<TaskQueueFactory> m_schedulerTaskQueueFactory;
         rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> m_peerConnectionFactory;
         rtc::scoped_refptr<DummyAudioDevice> m_audioDevice;
         std::vector<rtc::scoped_refptr<const webrtc::RTCStatsReport>> m_listStatsReport;
@@ -167,6 +187,9 @@ namespace webrtc
         std::map<const uint32_t, std::shared_ptr<UnityVideoRenderer>> m_mapVideoRenderer;
         std::map<const AudioTrackSinkAdapter*, std::unique_ptr<AudioTrackSinkAdapter>> m_mapAudioTrackAndSink;
         std::map<const rtc::RefCountInterface*, rtc::scoped_refptr<rtc::RefCountInterface>> m_mapRefPtr;
+        // The ids of the video sources which were created by this context, and removed from |m_mapRefPtr|.
+        std::map<const rtc::RefCountInterface*, uint64_t> m_mapVideoSourceId;
+        std::vector<uint64_t> m_removedVideoSourceIds;
 
         static uint32_t s_rendererId;
         static uint32_t GenerateRendererId();
@@ -11,6 +11,8 @@ namespace webrtc
 {
     DummyAudioDevice::DummyAudioDevice(TaskQueueFactory* taskQueueFactory)
         : audio_data(kChannels * kSamplesPerFrame)
+        , clock_(Clock::GetRealTimeClock())
+        , tickScheduler_(TimeDelta::Millis(kFrameLengthMs), kMaxCatchUpTicks)
         , tackQueueFactory_(taskQueueFactory)
     {
     }
@@ -19,9 +21,10 @@ namespace webrtc
     {
         taskQueue_ = std::make_unique<rtc::TaskQueue>(
             tackQueueFactory_->CreateTaskQueue("AudioDevice", TaskQueueFactory::Priority::NORMAL));
-        task_ = RepeatingTaskHandle::Start(taskQueue_->Get(), [this]() {
-            ProcessAudio();
-            return TimeDelta::Millis(kFrameLengthMs);
+        taskQueue_->PostTask([this]() {
+            ticking_ = true;
+            tickScheduler_.Start(clock_->CurrentTime());
+            Tick();
         });
         initialized_ = true;
         return 0;
@@ -34,7 +37,7 @@ namespace webrtc
 
         initialized_ = false;
 
-        taskQueue_->PostTask([this] { task_.Stop(); });
+        taskQueue_->PostTask([this] { ticking_ = false; });
 
         StopRecording();
         StopPlayout();
@@ -42,6 +45,20 @@ namespace webrtc
         return 0;
     }
 
+    // RepeatingTaskHandle posts the next task with the low precision, which may
+    // be delayed by several milliseconds. The task is posted with the high
+    // precision toward the absolute deadline instead.
+    void DummyAudioDevice::Tick()
+    {
+        if (!ticking_)
+            return;
+        const Timestamp deadline = tickScheduler_.OnTick(clock_->CurrentTime());
+        ProcessAudio();
+        // The time of processing the audio is subtracted from the delay.
+        const TimeDelta delay = std::max(deadline - clock_->CurrentTime(), TimeDelta::Zero());
+        taskQueue_->Get()->PostDelayedHighPrecisionTask([this]() { Tick(); }, delay);
+    }
+
     void DummyAudioDevice::ProcessAudio()
     {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -57,7 +74,7 @@ namespace webrtc
             // audio data here is not used.
             // The original function of the method is getting final audio data that resampling
             // and mixing multiple audio stream. But we want each audio streams, not final
-            // result.
+            // result. PerStreamAudioMixer only pulls each stream and skips the mixing.
             audio_transport_->PullRenderData(
                 kBytesPerSample * 8, kSamplingRate, kChannels, kSamplesPerFrame, data, &elapsed_time_ms, &ntp_time_ms);
         }
@@ -6,8 +6,9 @@
 #include <modules/audio_device/include/audio_device.h>
 #include <rtc_base/platform_thread.h>
 #include <rtc_base/task_queue.h>
-#include <rtc_base/task_utils/repeating_task.h>
+#include <system_wrappers/include/clock.h>
 
+#include "AudioTickScheduler.h"
 #include "WebRTCPlugin.h"
 
 namespace unity
@@ -177,7 +178,11 @@ namespace webrtc
         virtual int GetRecordAudioParameters(webrtc::AudioParameters* params) const override { return 0; }
 #endif
 
+        // The jitter of the 10 ms tick which pulls the audio of the receivers.
+        AudioTickStats GetTickStats() const { return tickScheduler_.GetStats(); }
+
     private:
+        void Tick();
         void ProcessAudio();
         bool PlayoutThreadProcess();
 
@@ -186,9 +191,14 @@ namespace webrtc
         const size_t kChannels = 2;
         const int32_t kSamplingRate = 48000;
         const size_t kSamplesPerFrame = static_cast<size_t>(kSamplingRate * kFrameLengthMs / 1000);
+        // 50 ms, the ticks missed beyond this are dropped.
+        const int kMaxCatchUpTicks = 5;
         std::vector<int16_t> audio_data;
         std::unique_ptr<rtc::TaskQueue> taskQueue_;
-        RepeatingTaskHandle task_;
+        Clock* clock_;
+        AudioTickScheduler tickScheduler_;
+        // Accessed only on |taskQueue_|.
+        bool ticking_ { false };
         std::atomic<bool> initialized_ { false };
         std::atomic<bool> playing_ { false };
         std::atomic<bool> recording_ { false };
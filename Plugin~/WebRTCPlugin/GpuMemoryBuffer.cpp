@@ -21,6 +21,8 @@ namespace webrtc
         , texture_(nullptr)
         , textureCpuRead_(nullptr)
         , handle_(nullptr)
+        , expectedUsage_(kUsageAll)
+        , readUsage_(kUsageNone)
     {
         uint32_t width = static_cast<uint32_t>(size.width());
         uint32_t height = static_cast<uint32_t>(size.height());
@@ -42,27 +44,110 @@ namespace webrtc
 
     bool GpuMemoryBufferFromUnity::ResetSync()
     {
-        if (!device_->ResetSync(texture_.get()))
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Fails while the GPU still uses the texture, then the pool tries the other buffer.
+
+        // Only the textures which have been written have the sync object to reset.
+        if (textureState_.needsReset)
         {
-            RTC_LOG(LS_INFO) << "ResetSync failed.";
-            return false;
+            if (!device_->ResetSync(texture_.get()))
+                return false;
+            textureState_.needsReset = false;
         }
-        if (!device_->ResetSync(textureCpuRead_.get()))
+        if (textureCpuReadState_.needsReset)
         {
-            RTC_LOG(LS_INFO) << "ResetSync failed.";
-            return false;
+            if (!device_->ResetSync(textureCpuRead_.get()))
+                return false;
+            textureCpuReadState_.needsReset = false;
         }
         return true;
     }
 
     bool GpuMemoryBufferFromUnity::CopyBuffer(NativeTexPtr ptr)
     {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Keep the previous expectation when the previous frame was dropped without reading.
+        uint32_t readUsage = readUsage_.exchange(kUsageNone);
+        if (readUsage != kUsageNone)
+            expectedUsage_ = readUsage;
+
+        textureState_.written = false;
+        textureCpuReadState_.written = false;
+        peekedI420_ = nullptr;
+
         // One texture cannot map CUDA memory and CPU memory simultaneously.
-        // Believe there is still room for improvement.
-        if (!device_->CopyResourceFromNativeV(texture_.get(), ptr))
+        if (expectedUsage_ & kUsageNativeHandle)
+        {
+            if (!device_->CopyResourceFromNativeV(texture_.get(), ptr))
+                return false;
+            textureState_ = { true, true };
+        }
+        if (expectedUsage_ & kUsageCpuRead)
+        {
+            if (!device_->CopyResourceFromNativeV(textureCpuRead_.get(), ptr))
+                return false;
+            textureCpuReadState_ = { true, true };
+        }
+        return true;
+    }
+
+    uint32_t GpuMemoryBufferFromUnity::copiedUsage() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t usage = kUsageNone;
+        if (textureState_.written)
+            usage |= kUsageNativeHandle;
+        if (textureCpuReadState_.written)
+            usage |= kUsageCpuRead;
+        return usage;
+    }
+
+    bool GpuMemoryBufferFromUnity::CopyFromOtherTexture(
+        ITexture2D* dest, TextureState& destState, ITexture2D* src, const TextureState& srcState) const
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (destState.written)
+                return true;
+            if (!srcState.written)
+                return false;
+        }
+
+        // D3D12, Vulkan and Metal copy only on the render thread, so the frame is dropped.
+        // The next frame is copied into |dest| because the usage has been recorded.
+        if (!device_->CanCopyResourceOnWorkerThread())
             return false;
-        if (!device_->CopyResourceFromNativeV(textureCpuRead_.get(), ptr))
+
+        // The wait may take up to 30 ms, so it must not block the other readers.
+        using namespace std::chrono_literals;
+        const std::chrono::nanoseconds timeout(30ms); // 30ms
+        if (!device_->WaitSync(src, timeout.count()))
+        {
+            RTC_LOG(LS_INFO) << "WaitSync failed.";
             return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        // The other reader may have copied it while waiting.
+        if (destState.written)
+            return true;
+        if (destState.needsReset)
+        {
+            if (!device_->ResetSync(dest))
+            {
+                RTC_LOG(LS_INFO) << "ResetSync failed.";
+                return false;
+            }
+            destState.needsReset = false;
+        }
+        if (!device_->CopyResourceV(dest, src))
+        {
+            RTC_LOG(LS_INFO) << "CopyResourceV failed.";
+            return false;
+        }
+        destState = { true, true };
         return true;
     }
 
@@ -70,20 +155,81 @@ namespace webrtc
 
     Size GpuMemoryBufferFromUnity::GetSize() const { return size_; }
 
-    rtc::scoped_refptr<I420BufferInterface> GpuMemoryBufferFromUnity::ToI420()
+    bool GpuMemoryBufferFromUnity::PrepareCpuRead()
     {
+        readUsage_ |= kUsageCpuRead;
+        // Fallback when the consumer differs from the expectation.
+        if (!CopyFromOtherTexture(textureCpuRead_.get(), textureCpuReadState_, texture_.get(), textureState_))
+            return false;
+
         using namespace std::chrono_literals;
         const std::chrono::nanoseconds timeout(30ms); // 30ms
         if (!device_->WaitSync(textureCpuRead_.get(), timeout.count()))
         {
             RTC_LOG(LS_INFO) << "WaitSync failed.";
-            return nullptr;
+            return false;
         }
+        return true;
+    }
+
+    rtc::scoped_refptr<I420BufferInterface> GpuMemoryBufferFromUnity::ToI420()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (peekedI420_)
+            {
+                readUsage_ |= kUsageCpuRead;
+                return peekedI420_;
+            }
+        }
+        if (!PrepareCpuRead())
+            return nullptr;
         return device_->ConvertRGBToI420(textureCpuRead_.get());
     }
 
+    rtc::scoped_refptr<I420BufferInterface> GpuMemoryBufferFromUnity::PeekI420()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (peekedI420_)
+                return peekedI420_;
+            // Reading back only for the caller would undo the learning of the usage.
+            if (!textureCpuReadState_.written)
+                return nullptr;
+        }
+
+        // The caller runs on the shared sequence of the capture, so it must not
+        // wait for the copy which has not finished yet.
+        if (!device_->WaitSync(textureCpuRead_.get(), 0))
+            return nullptr;
+        rtc::scoped_refptr<I420BufferInterface> buffer = device_->ConvertRGBToI420(textureCpuRead_.get());
+        std::lock_guard<std::mutex> lock(mutex_);
+        peekedI420_ = buffer;
+        return buffer;
+    }
+
+    rtc::scoped_refptr<NV12BufferInterface> GpuMemoryBufferFromUnity::ToNV12()
+    {
+        if (!PrepareCpuRead())
+            return nullptr;
+        rtc::scoped_refptr<NV12Buffer> nv12Buffer = device_->ConvertRGBToNV12(textureCpuRead_.get());
+        if (nv12Buffer)
+            return nv12Buffer;
+
+        // The device converts only to I420.
+        rtc::scoped_refptr<I420Buffer> i420Buffer = device_->ConvertRGBToI420(textureCpuRead_.get());
+        if (!i420Buffer)
+            return nullptr;
+        return NV12Buffer::Copy(*i420Buffer);
+    }
+
     const GpuMemoryBufferHandle* GpuMemoryBufferFromUnity::handle() const
     {
+        readUsage_ |= kUsageNativeHandle;
+        // Fallback when the consumer differs from the expectation.
+        if (!CopyFromOtherTexture(texture_.get(), textureState_, textureCpuRead_.get(), textureCpuReadState_))
+            return nullptr;
+
         using namespace std::chrono_literals;
         const std::chrono::nanoseconds timeout(30ms); // 30ms
         if (!device_->WaitSync(texture_.get(), timeout.count()))
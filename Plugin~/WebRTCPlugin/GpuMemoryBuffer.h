@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include <shared_mutex>
 
 #include <common_video/include/video_frame_buffer.h>
@@ -35,6 +37,11 @@ namespace webrtc
         virtual Size GetSize() const = 0;
         virtual UnityRenderingExtTextureFormat GetFormat() const = 0;
         virtual rtc::scoped_refptr<I420BufferInterface> ToI420() = 0;
+        virtual rtc::scoped_refptr<NV12BufferInterface> ToNV12() = 0;
+        // Converts only if the CPU readable copy of the frame already exists and
+        // the copy has finished, and is not counted as the read of the consumer.
+        // Returns nullptr otherwise without waiting.
+        virtual rtc::scoped_refptr<I420BufferInterface> PeekI420() = 0;
 
         virtual const GpuMemoryBufferHandle* handle() const = 0;
 
@@ -42,9 +49,23 @@ namespace webrtc
         ~GpuMemoryBufferInterface() override = default;
     };
 
+    // Copies the frame only into the texture which the consumer reads.
+    // The consumer of the previous frame decides the destination of the next copy,
+    // and the other texture is copied from the first one when it is requested,
+    // if the device can copy on the thread of the consumer. Otherwise the read fails.
     class GpuMemoryBufferFromUnity : public GpuMemoryBufferInterface
     {
     public:
+        enum Usage : uint32_t
+        {
+            kUsageNone = 0,
+            // Read through the native handle by hardware encoders.
+            kUsageNativeHandle = 1 << 0,
+            // Read through ToI420 by software encoders.
+            kUsageCpuRead = 1 << 1,
+            kUsageAll = kUsageNativeHandle | kUsageCpuRead,
+        };
+
         GpuMemoryBufferFromUnity(IGraphicsDevice* device, const Size& size, UnityRenderingExtTextureFormat format);
         GpuMemoryBufferFromUnity(const GpuMemoryBufferFromUnity&) = delete;
         GpuMemoryBufferFromUnity& operator=(const GpuMemoryBufferFromUnity&) = delete;
@@ -54,8 +75,13 @@ namespace webrtc
         UnityRenderingExtTextureFormat GetFormat() const override;
         Size GetSize() const override;
         rtc::scoped_refptr<I420BufferInterface> ToI420() override;
+        rtc::scoped_refptr<NV12BufferInterface> ToNV12() override;
+        rtc::scoped_refptr<I420BufferInterface> PeekI420() override;
         const GpuMemoryBufferHandle* handle() const override;
 
+        // The textures which the last CopyBuffer wrote into.
+        uint32_t copiedUsage() const;
+
     protected:
         ~GpuMemoryBufferFromUnity() override;
 
@@ -66,6 +92,29 @@ namespace webrtc
         std::unique_ptr<ITexture2D> texture_;
         std::unique_ptr<ITexture2D> textureCpuRead_;
         std::unique_ptr<GpuMemoryBufferHandle> handle_;
+
+        struct TextureState
+        {
+            // The texture holds the current frame.
+            bool written = false;
+            // The sync object of the texture needs to reset before writing.
+            bool needsReset = false;
+        };
+        // Copies |src| into |dest| unless |dest| already holds the current frame.
+        // Waits for |src| without holding |mutex_|.
+        bool CopyFromOtherTexture(
+            ITexture2D* dest, TextureState& destState, ITexture2D* src, const TextureState& srcState) const;
+        // Waits until the texture for the CPU read holds the current frame.
+        bool PrepareCpuRead();
+
+        mutable std::mutex mutex_;
+        mutable TextureState textureState_;
+        mutable TextureState textureCpuReadState_;
+        // Converted by PeekI420, and reused by ToI420 for the same frame.
+        rtc::scoped_refptr<I420BufferInterface> peekedI420_;
+        // Usages learned from the consumers of the previous frames.
+        uint32_t expectedUsage_;
+        mutable std::atomic<uint32_t> readUsage_;
     };
 }
 }
@@ -12,6 +12,10 @@ namespace webrtc
 {
     GpuMemoryBufferPool::GpuMemoryBufferPool(IGraphicsDevice* device, Clock* clock)
         : device_(device)
+        , bufferCount_(0)
+        , maxBufferCount_(kDefaultMaxBufferCount)
+        , hitCount_(0)
+        , missCount_(0)
         , clock_(clock)
     {
     }
@@ -21,84 +25,188 @@ namespace webrtc
     rtc::scoped_refptr<VideoFrame> GpuMemoryBufferPool::CreateFrame(
         NativeTexPtr ptr, const Size& size, UnityRenderingExtTextureFormat format, Timestamp timestamp)
     {
-        auto buffer = GetOrCreateFrameResources(ptr, size, format);
+        bool created = false;
+        FrameResources* resources = GetOrCreateFrameResources(size, format, &created);
+        if (!resources)
+            return nullptr;
+
+        // Copies without the lock, so that the returning buffers are not blocked by the GPU copy.
+        GpuMemoryBufferFromUnity* buffer = static_cast<GpuMemoryBufferFromUnity*>(resources->buffer_.get());
+        if (!buffer->CopyBuffer(ptr))
+        {
+            RTC_LOG(LS_INFO) << "Copy buffer is failed.";
+            OnReturnBuffer(resources);
+            return nullptr;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (created)
+                missCount_++;
+            else
+                hitCount_++;
+        }
+
         VideoFrame::ReturnBufferToPoolCallback callback =
-            std::bind(&GpuMemoryBufferPool::OnReturnBuffer, this, std::placeholders::_1);
+            [this, resources](rtc::scoped_refptr<GpuMemoryBufferInterface>) { OnReturnBuffer(resources); };
 
         return VideoFrame::WrapExternalGpuMemoryBuffer(
-            size, buffer, callback, webrtc::TimeDelta::Micros(timestamp.us()));
+            size, resources->buffer_, callback, webrtc::TimeDelta::Micros(timestamp.us()));
     }
 
-    rtc::scoped_refptr<GpuMemoryBufferInterface> GpuMemoryBufferPool::GetOrCreateFrameResources(
-        NativeTexPtr ptr, const Size& size, UnityRenderingExtTextureFormat format)
+    GpuMemoryBufferPool::FrameResources*
+    GpuMemoryBufferPool::GetOrCreateFrameResources(
+        const Size& size, UnityRenderingExtTextureFormat format, bool* created)
     {
-        for (auto it = resourcesPool_.begin(); it != resourcesPool_.end(); ++it)
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // From the least recently used buffer, which most likely has signaled.
+        Bucket& bucket = buckets_[BucketKey { size, format }];
+        for (auto it = bucket.freeList.rbegin(); it != bucket.freeList.rend(); ++it)
         {
-            FrameResources* resources = it->get();
-            if (!resources->IsUsed() && AreFrameResourcesCompatible(resources, size, format))
-            {
-                GpuMemoryBufferFromUnity* buffer = static_cast<GpuMemoryBufferFromUnity*>(resources->buffer_.get());
-                if (!buffer->ResetSync())
-                {
-                    RTC_LOG(LS_INFO) << "It has not signaled yet";
-                    continue;
-                }
-                if (!buffer->CopyBuffer(ptr))
-                {
-                    RTC_LOG(LS_INFO) << "Copy buffer is failed.";
-                    continue;
-                }
-                resources->MarkUsed(clock_->CurrentTime());
-                return resources->buffer_;
-            }
+            FrameResources* resources = *it;
+            GpuMemoryBufferFromUnity* buffer = static_cast<GpuMemoryBufferFromUnity*>(resources->buffer_.get());
+            if (!buffer->ResetSync())
+                continue;
+            bucket.freeList.erase(std::next(it).base());
+            resources->MarkUsed(clock_->CurrentTime());
+            *created = false;
+            return resources;
         }
-        rtc::scoped_refptr<GpuMemoryBufferFromUnity> buffer =
-            rtc::make_ref_counted<GpuMemoryBufferFromUnity>(device_, size, format);
-        if (!buffer->CopyBuffer(ptr))
+
+        if (bufferCount_ >= maxBufferCount_ && !EvictFreeBuffer(bucket))
         {
-            RTC_LOG(LS_INFO) << "Copy buffer is failed.";
+            RTC_LOG(LS_INFO) << "The number of buffers reached the limit.";
             return nullptr;
         }
-        std::unique_ptr<FrameResources> resources = std::make_unique<FrameResources>(buffer);
+
+        FrameResources* resources =
+            AddFrameResources(bucket, rtc::make_ref_counted<GpuMemoryBufferFromUnity>(device_, size, format));
         resources->MarkUsed(clock_->CurrentTime());
-        resourcesPool_.push_back(std::move(resources));
-        return std::move(buffer);
+        *created = true;
+        return resources;
     }
 
-    bool GpuMemoryBufferPool::AreFrameResourcesCompatible(
-        const FrameResources* resources, const Size& size, UnityRenderingExtTextureFormat format)
+    size_t GpuMemoryBufferPool::Prewarm(const Size& size, UnityRenderingExtTextureFormat format, size_t count)
     {
-        return resources->buffer_->GetSize() == size && resources->buffer_->GetFormat() == format;
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        Bucket& bucket = buckets_[BucketKey { size, format }];
+        const Timestamp now = clock_->CurrentTime();
+        size_t allocated = 0;
+        for (; allocated < count; allocated++)
+        {
+            if (bufferCount_ >= maxBufferCount_ && !EvictFreeBuffer(bucket))
+                break;
+            FrameResources* resources =
+                AddFrameResources(bucket, rtc::make_ref_counted<GpuMemoryBufferFromUnity>(device_, size, format));
+            resources->MarkUnused(now);
+            bucket.freeList.push_front(resources);
+        }
+        return allocated;
     }
 
-    void GpuMemoryBufferPool::OnReturnBuffer(rtc::scoped_refptr<GpuMemoryBufferInterface> buffer)
+    GpuMemoryBufferPool::FrameResources*
+    GpuMemoryBufferPool::AddFrameResources(Bucket& bucket, rtc::scoped_refptr<GpuMemoryBufferInterface> buffer)
     {
-        GpuMemoryBufferInterface* ptr = buffer.get();
-        auto result =
-            std::find_if(resourcesPool_.begin(), resourcesPool_.end(), [ptr](std::unique_ptr<FrameResources>& x) {
-                return x->buffer_.get() == ptr;
-            });
-        RTC_DCHECK(result != resourcesPool_.end());
-
-        (*result)->MarkUnused(clock_->CurrentTime());
+        bucket.resources.push_back(std::make_unique<FrameResources>(std::move(buffer), &bucket));
+        FrameResources* resources = bucket.resources.back().get();
+        resources->poolIt_ = std::prev(bucket.resources.end());
+        bufferCount_++;
+        return resources;
+    }
+
+    bool GpuMemoryBufferPool::EvictFreeBuffer(const Bucket& except)
+    {
+        // The least recently used buffer of each bucket is at the back of the free list.
+        auto oldest = buckets_.end();
+        for (auto it = buckets_.begin(); it != buckets_.end(); ++it)
+        {
+            const Bucket& bucket = it->second;
+            if (&bucket == &except || bucket.freeList.empty())
+                continue;
+            if (oldest == buckets_.end() ||
+                bucket.freeList.back()->lastUseTime() < oldest->second.freeList.back()->lastUseTime())
+                oldest = it;
+        }
+        if (oldest == buckets_.end())
+            return false;
+
+        Bucket& bucket = oldest->second;
+        FrameResources* resources = bucket.freeList.back();
+        bucket.freeList.pop_back();
+        bucket.resources.erase(resources->poolIt_);
+        bufferCount_--;
+        if (bucket.resources.empty())
+            buckets_.erase(oldest);
+        return true;
+    }
+
+    void GpuMemoryBufferPool::OnReturnBuffer(FrameResources* resources)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        RTC_DCHECK(resources->IsUsed());
+
+        resources->MarkUnused(clock_->CurrentTime());
+        Bucket* bucket = resources->bucket_;
+        bucket->freeList.push_front(resources);
     }
 
     void GpuMemoryBufferPool::ReleaseStaleBuffers(Timestamp now, TimeDelta timeLimit)
     {
-        auto it = resourcesPool_.begin();
-        while (it != resourcesPool_.end())
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = buckets_.begin();
+        while (it != buckets_.end())
         {
-            FrameResources* resources = (*it).get();
+            Bucket& bucket = it->second;
 
-            if (!resources->IsUsed() && now - resources->lastUseTime() > timeLimit)
+            // The stalest buffer is at the back of the free list.
+            while (!bucket.freeList.empty())
             {
-                resourcesPool_.erase(it++);
+                FrameResources* resources = bucket.freeList.back();
+                if (now - resources->lastUseTime() <= timeLimit)
+                    break;
+                bucket.freeList.pop_back();
+                bucket.resources.erase(resources->poolIt_);
+                bufferCount_--;
             }
+
+            if (bucket.resources.empty())
+                it = buckets_.erase(it);
             else
-            {
-                it++;
-            }
+                ++it;
         }
     }
+
+    void GpuMemoryBufferPool::SetMaxBufferCount(size_t maxBufferCount)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        maxBufferCount_ = maxBufferCount;
+    }
+
+    size_t GpuMemoryBufferPool::maxBufferCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return maxBufferCount_;
+    }
+
+    size_t GpuMemoryBufferPool::bufferCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return bufferCount_;
+    }
+
+    size_t GpuMemoryBufferPool::hitCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return hitCount_;
+    }
+
+    size_t GpuMemoryBufferPool::missCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return missCount_;
+    }
 }
 }
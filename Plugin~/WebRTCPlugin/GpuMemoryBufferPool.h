@@ -1,6 +1,8 @@
 #pragma once
 
 #include <list>
+#include <mutex>
+#include <unordered_map>
 #include <system_wrappers/include/clock.h>
 
 #include "GpuMemoryBuffer.h"
@@ -14,6 +16,9 @@ namespace webrtc
     class GpuMemoryBufferPool
     {
     public:
+        static constexpr size_t kDefaultMaxBufferCount = 20;
+        static constexpr TimeDelta kDefaultStaleFrameLimit = TimeDelta::Seconds(10);
+
         GpuMemoryBufferPool(IGraphicsDevice* device, Clock* clock);
         GpuMemoryBufferPool(const GpuMemoryBufferPool&) = delete;
         GpuMemoryBufferPool& operator=(const GpuMemoryBufferPool&) = delete;
@@ -24,14 +29,47 @@ namespace webrtc
         CreateFrame(NativeTexPtr ptr, const Size& size, UnityRenderingExtTextureFormat format, Timestamp timestamp);
         void ReleaseStaleBuffers(Timestamp timestamp, TimeDelta timeLimit);
 
-        size_t bufferCount() { return resourcesPool_.size(); }
+        // Allocates |count| buffers ahead so that the first frames don't pay for
+        // the allocation. Releases the free buffers of the other sizes and formats
+        // at the limit like CreateFrame. Returns the number of allocated buffers.
+        // Must be called on the render thread.
+        size_t Prewarm(const Size& size, UnityRenderingExtTextureFormat format, size_t count);
+
+        // When the pool already has |maxBufferCount| buffers, CreateFrame releases
+        // the least recently used free buffer of the other sizes and formats. It
+        // returns nullptr instead of allocating a new buffer if there is none.
+        void SetMaxBufferCount(size_t maxBufferCount);
+        size_t maxBufferCount();
+
+        size_t bufferCount();
+
+        // The number of frames which reused the buffer in the pool. The frames
+        // which failed to copy are not counted.
+        size_t hitCount();
+        // The number of frames which needed to allocate a new buffer.
+        size_t missCount();
 
     private:
+        struct FrameResources;
+        using ResourcesList = std::list<std::unique_ptr<FrameResources>>;
+        using FreeList = std::list<FrameResources*>;
+
+        // Buffers which have the same size and format.
+        // |freeList| is ordered by the time of returning to the pool, so the most
+        // recently used buffer is at the front and the stalest one is at the back.
+        struct Bucket
+        {
+            ResourcesList resources;
+            FreeList freeList;
+        };
+
         struct FrameResources
         {
-            FrameResources(rtc::scoped_refptr<GpuMemoryBufferInterface> buffer)
+            FrameResources(rtc::scoped_refptr<GpuMemoryBufferInterface> buffer, Bucket* bucket)
                 : buffer_(std::move(buffer))
+                , isUsed_(false)
                 , lastUsetime_(Timestamp::Zero())
+                , bucket_(bucket)
             {
             }
             rtc::scoped_refptr<GpuMemoryBufferInterface> buffer_;
@@ -49,16 +87,48 @@ namespace webrtc
             Timestamp lastUseTime() { return lastUsetime_; }
             bool isUsed_;
             Timestamp lastUsetime_;
+
+            // Back-pointers to remove the resources from the pool in O(1).
+            Bucket* bucket_;
+            ResourcesList::iterator poolIt_;
+        };
+
+        struct BucketKey
+        {
+            Size size;
+            UnityRenderingExtTextureFormat format;
+
+            bool operator==(const BucketKey& other) const { return size == other.size && format == other.format; }
+        };
+
+        struct BucketKeyHash
+        {
+            size_t operator()(const BucketKey& key) const
+            {
+                size_t hash = std::hash<int>()(key.size.width());
+                hash = hash * 31 + std::hash<int>()(key.size.height());
+                hash = hash * 31 + std::hash<int>()(static_cast<int>(key.format));
+                return hash;
+            }
         };
-        rtc::scoped_refptr<GpuMemoryBufferInterface>
-        GetOrCreateFrameResources(NativeTexPtr ptr, const Size& size, UnityRenderingExtTextureFormat format);
-        void OnReturnBuffer(rtc::scoped_refptr<GpuMemoryBufferInterface> buffer);
 
-        static bool AreFrameResourcesCompatible(
-            const FrameResources* resources, const Size& size, UnityRenderingExtTextureFormat format);
+        // Takes the free buffer or creates the new one, without copying the frame.
+        // |created| is set to true if the buffer is new.
+        FrameResources*
+        GetOrCreateFrameResources(const Size& size, UnityRenderingExtTextureFormat format, bool* created);
+        // Releases the least recently used free buffer which is not in |except|.
+        // Returns false if there is no such buffer.
+        bool EvictFreeBuffer(const Bucket& except);
+        FrameResources* AddFrameResources(Bucket& bucket, rtc::scoped_refptr<GpuMemoryBufferInterface> buffer);
+        void OnReturnBuffer(FrameResources* resources);
 
         IGraphicsDevice* device_;
-        std::list<std::unique_ptr<FrameResources>> resourcesPool_;
+        std::mutex mutex_;
+        std::unordered_map<BucketKey, Bucket, BucketKeyHash> buckets_;
+        size_t bufferCount_;
+        size_t maxBufferCount_;
+        size_t hitCount_;
+        size_t missCount_;
         Clock* const clock_;
     };
 }
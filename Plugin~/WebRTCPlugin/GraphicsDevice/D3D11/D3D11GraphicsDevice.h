@@ -1,6 +1,7 @@
 #pragma once
 
 #include <d3d11.h>
+#include <functional>
 #include <memory>
 #include <wrl/client.h>
 
@@ -28,15 +29,20 @@ namespace webrtc
         virtual ITexture2D*
         CreateCPUReadTextureV(uint32_t w, uint32_t h, UnityRenderingExtTextureFormat textureFormat) override;
         virtual bool CopyResourceV(ITexture2D* dest, ITexture2D* src) override;
+        // The device is multithread protected.
+        bool CanCopyResourceOnWorkerThread() const override { return true; }
         virtual bool CopyResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) override;
         std::unique_ptr<GpuMemoryBufferHandle> Map(ITexture2D* texture) override;
         virtual rtc::scoped_refptr<::webrtc::I420Buffer> ConvertRGBToI420(ITexture2D* tex) override;
+        virtual rtc::scoped_refptr<::webrtc::NV12Buffer> ConvertRGBToNV12(ITexture2D* tex) override;
         bool IsCudaSupport() override { return m_isCudaSupport; }
         CUcontext GetCUcontext() override { return m_cudaContext.GetContext(); }
         NV_ENC_BUFFER_FORMAT GetEncodeBufferFormat() override { return NV_ENC_BUFFER_FORMAT_ARGB; }
 
     private:
         HRESULT WaitFlush();
+        // Maps the staging texture |tex| and passes the pixels to |func|.
+        bool MapPixelBuffer(ITexture2D* tex, std::function<void(const uint8_t* data, int stride)> func);
         ID3D11Device* m_d3d11Device;
 
         bool m_isCudaSupport;
@@ -8,6 +8,7 @@
 #include "GraphicsDevice/Cuda/GpuMemoryBufferCudaHandle.h"
 #include "GraphicsDevice/D3D11/D3D11Texture2D.h"
 #include "GraphicsDevice/GraphicsUtility.h"
+#include "GraphicsDevice/RGBToI420Converter.h"
 #include "NvCodecUtils.h"
 
 // nonstandard extension used : class rvalue used as lvalue
@@ -314,20 +315,19 @@ namespace webrtc
     }
 
     //----------------------------------------------------------------------------------------------------------------------
-    rtc::scoped_refptr<webrtc::I420Buffer> D3D12GraphicsDevice::ConvertRGBToI420(ITexture2D* baseTex)
+    bool D3D12GraphicsDevice::MapPixelBuffer(
+        ITexture2D* baseTex, std::function<void(const uint8_t* data, int stride)> func)
     {
         D3D12Texture2D* tex = reinterpret_cast<D3D12Texture2D*>(baseTex);
         assert(nullptr != tex);
         if (nullptr == tex)
-            return nullptr;
+            return false;
 
         ID3D12Resource* readbackResource = tex->GetReadbackResource();
         assert(nullptr != readbackResource);
         if (nullptr == readbackResource) // the texture has to be prepared for CPU access
-            return nullptr;
+            return false;
 
-        const int width = static_cast<int>(tex->GetWidth());
-        const int height = static_cast<int>(tex->GetHeight());
         const D3D12ResourceFootprint* footprint = tex->GetNativeTextureFootprint();
         const int rowPitch = static_cast<int>(footprint->Footprint.Footprint.RowPitch);
 
@@ -337,29 +337,50 @@ namespace webrtc
         assert(hr == S_OK);
         if (hr != S_OK)
         {
-            return nullptr;
+            return false;
         }
 
-        // RGBA -> I420
-        rtc::scoped_refptr<webrtc::I420Buffer> i420_buffer = webrtc::I420Buffer::Create(width, height);
-        libyuv::ARGBToI420(
-            static_cast<uint8_t*>(data),
-            rowPitch,
-            i420_buffer->MutableDataY(),
-            i420_buffer->StrideY(),
-            i420_buffer->MutableDataU(),
-            i420_buffer->StrideU(),
-            i420_buffer->MutableDataV(),
-            i420_buffer->StrideV(),
-            width,
-            height);
+        func(static_cast<uint8_t*>(data), rowPitch);
 
         D3D12_RANGE emptyRange { 0, 0 };
         readbackResource->Unmap(0, &emptyRange);
+        return true;
+    }
 
+    rtc::scoped_refptr<webrtc::I420Buffer> D3D12GraphicsDevice::ConvertRGBToI420(ITexture2D* tex)
+    {
+        const int width = static_cast<int>(tex->GetWidth());
+        const int height = static_cast<int>(tex->GetHeight());
+
+        // RGBA -> I420
+        rtc::scoped_refptr<webrtc::I420Buffer> i420_buffer;
+        MapPixelBuffer(
+            tex,
+            [&](const uint8_t* data, int stride)
+            {
+                RGBToI420Converter converter(GetWorkerThreadPool());
+                i420_buffer = converter.Convert(libyuv::ARGBToI420, data, stride, width, height);
+            });
         return i420_buffer;
     }
 
+    rtc::scoped_refptr<webrtc::NV12Buffer> D3D12GraphicsDevice::ConvertRGBToNV12(ITexture2D* tex)
+    {
+        const int width = static_cast<int>(tex->GetWidth());
+        const int height = static_cast<int>(tex->GetHeight());
+
+        // RGBA -> NV12
+        rtc::scoped_refptr<webrtc::NV12Buffer> nv12_buffer;
+        MapPixelBuffer(
+            tex,
+            [&](const uint8_t* data, int stride)
+            {
+                RGBToI420Converter converter(GetWorkerThreadPool());
+                nv12_buffer = converter.ConvertToNV12(libyuv::ARGBToNV12, data, stride, width, height);
+            });
+        return nv12_buffer;
+    }
+
     std::unique_ptr<GpuMemoryBufferHandle> D3D12GraphicsDevice::Map(ITexture2D* texture)
     {
         if (!IsCudaSupport())
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <comdef.h>
+#include <functional>
 #include <d3d11_4.h>
 #include <d3d12.h>
 #include <stdexcept>
@@ -80,6 +81,7 @@ namespace webrtc
         virtual ITexture2D*
         CreateCPUReadTextureV(uint32_t w, uint32_t h, UnityRenderingExtTextureFormat textureFormat) override;
         virtual rtc::scoped_refptr<webrtc::I420Buffer> ConvertRGBToI420(ITexture2D* tex) override;
+        virtual rtc::scoped_refptr<webrtc::NV12Buffer> ConvertRGBToNV12(ITexture2D* tex) override;
 
         bool IsCudaSupport() override { return m_isCudaSupport; }
         CUcontext GetCUcontext() override { return m_cudaContext.GetContext(); }
@@ -87,6 +89,8 @@ namespace webrtc
 
     private:
         D3D12Texture2D* CreateSharedD3D12Texture(uint32_t w, uint32_t h);
+        // Maps the readback resource of |tex| and passes the pixels to |func|.
+        bool MapPixelBuffer(ITexture2D* tex, std::function<void(const uint8_t* data, int stride)> func);
         void WaitForFence(ID3D12Fence* fence, HANDLE handle, uint64_t* fenceValue);
         void Barrier(
             ID3D12Resource* res,
@@ -2,6 +2,7 @@
 
 #include "GpuMemoryBuffer.h"
 #include "GraphicsDevice.h"
+#include "Software/SoftwareGraphicsDevice.h"
 
 #if SUPPORT_D3D11 && SUPPORT_D3D12
 #include "D3D11/D3D11GraphicsDevice.h"
@@ -156,6 +157,11 @@ namespace webrtc
             break;
         }
 #endif
+        case kUnityGfxRendererNull:
+        {
+            // Unity runs without graphics device (e.g. -nographics option).
+            return Init(rendererType, nullptr, nullptr, profiler);
+        }
         default:
         {
             return nullptr;
@@ -230,6 +236,11 @@ namespace webrtc
             break;
         }
 #endif
+        case kUnityGfxRendererNull:
+        {
+            pDevice = new SoftwareGraphicsDevice(renderer, profiler);
+            break;
+        }
         default:
         {
             DebugError("Unsupported Unity Renderer: %d", renderer);
@@ -4,10 +4,12 @@
 
 #include <IUnityRenderingExtensions.h>
 #include <api/video/i420_buffer.h>
+#include <api/video/nv12_buffer.h>
 
 #include "PlatformBase.h"
 #include "ProfilerMarkerFactory.h"
 #include "ScopedProfiler.h"
+#include "WorkerThreadPool.h"
 
 #if CUDA_PLATFORM
 #include "Cuda/ICudaDevice.h"
@@ -30,6 +32,7 @@ namespace webrtc
         IGraphicsDevice(UnityGfxRenderer renderer, ProfilerMarkerFactory* profiler)
             : m_gfxRenderer(renderer)
             , m_profiler(profiler)
+            , m_workerThreadPool(std::make_unique<WorkerThreadPool>(WorkerThreadPool::DefaultThreadCount()))
         {
         }
 #if CUDA_PLATFORM
@@ -43,6 +46,8 @@ namespace webrtc
         CreateDefaultTextureV(uint32_t width, uint32_t height, UnityRenderingExtTextureFormat textureFormat) = 0;
         virtual void* GetEncodeDevicePtrV() = 0;
         virtual bool CopyResourceV(ITexture2D* dest, ITexture2D* src) = 0;
+        // True if CopyResourceV may be called on the threads of the encoders, not only on the render thread.
+        virtual bool CanCopyResourceOnWorkerThread() const { return false; }
         virtual bool CopyResourceFromNativeV(ITexture2D* dest, NativeTexPtr nativeTexturePtr) = 0;
         virtual UnityGfxRenderer GetGfxRenderer() const { return m_gfxRenderer; }
         virtual std::unique_ptr<GpuMemoryBufferHandle> Map(ITexture2D* texture) = 0;
@@ -53,10 +58,16 @@ namespace webrtc
         virtual ITexture2D*
         CreateCPUReadTextureV(uint32_t width, uint32_t height, UnityRenderingExtTextureFormat textureFormat) = 0;
         virtual rtc::scoped_refptr<::webrtc::I420Buffer> ConvertRGBToI420(ITexture2D* tex) = 0;
+        // Returns nullptr if the device does not convert to NV12 directly.
+        virtual rtc::scoped_refptr<::webrtc::NV12Buffer> ConvertRGBToNV12(ITexture2D* tex) { return nullptr; }
+
+        // The worker threads for the conversions on the render thread. Joined when the device is destroyed.
+        WorkerThreadPool* GetWorkerThreadPool() const { return m_workerThreadPool.get(); }
 
     protected:
         UnityGfxRenderer m_gfxRenderer;
         ProfilerMarkerFactory* m_profiler;
+        std::unique_ptr<WorkerThreadPool> m_workerThreadPool;
     };
 
 } // end namespace webrtc
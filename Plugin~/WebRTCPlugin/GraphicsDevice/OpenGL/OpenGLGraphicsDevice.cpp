@@ -8,6 +8,7 @@
 #include "third_party/libyuv/include/libyuv.h"
 
 #include "GraphicsDevice/GraphicsUtility.h"
+#include "GraphicsDevice/RGBToI420Converter.h"
 #include "OpenGLGraphicsDevice.h"
 #include "OpenGLTexture2D.h"
 
@@ -106,25 +107,60 @@ namespace webrtc
         return tex;
     }
 
+    static void GetTexImage(GLenum target, GLint level, GLenum format, GLenum type, void* pixels)
+    {
+#if SUPPORT_OPENGL_CORE
+        glGetTexImage(target, level, format, type, pixels);
+#elif SUPPORT_OPENGL_ES
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo[0]);
+
+        int width = 0;
+        int height = 0;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+
+        GLint tex;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &tex);
+
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex, 0);
+
+        // read pixels from framebuffer to PBO
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glReadPixels(0, 0, width, height, format, type, pixels);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+#endif
+    }
+
+    void OpenGLGraphicsDevice::EnsureCurrentContext()
+    {
+        if (OpenGLContext::CurrentContext())
+            return;
+        // The worker threads of the encoders create their contexts concurrently.
+        std::lock_guard<std::mutex> lock(contextsMutex_);
+        contexts_.push_back(OpenGLContext::CreateGLContext(mainContext_.get()));
+    }
+
     bool OpenGLGraphicsDevice::CopyResourceV(ITexture2D* dst, ITexture2D* src)
     {
+        // This method may be called on the worker thread which reads the frame.
+        EnsureCurrentContext();
+
         OpenGLTexture2D* srcTexture = static_cast<OpenGLTexture2D*>(src);
         OpenGLTexture2D* dstTexture = static_cast<OpenGLTexture2D*>(dst);
         const GLuint srcName = srcTexture->GetTexture();
-        const GLuint dstName = dstTexture->GetTexture();
-        return CopyResource(dstName, srcName);
+        return CopyResource(dstTexture, srcName);
     }
 
     bool OpenGLGraphicsDevice::CopyResourceFromNativeV(ITexture2D* dst, void* nativeTexturePtr)
     {
         OpenGLTexture2D* dstTexture = static_cast<OpenGLTexture2D*>(dst);
         const GLuint srcName = reinterpret_cast<uintptr_t>(nativeTexturePtr);
-        const GLuint dstName = dstTexture->GetTexture();
-        return CopyResource(dstName, srcName);
+        return CopyResource(dstTexture, srcName);
     }
 
-    bool OpenGLGraphicsDevice::CopyResource(GLuint dstName, GLuint srcName)
+    bool OpenGLGraphicsDevice::CopyResource(OpenGLTexture2D* dstTexture, GLuint srcName)
     {
+        const GLuint dstName = dstTexture->GetTexture();
         if (srcName == dstName)
         {
             RTC_LOG(LS_INFO) << "Same texture";
@@ -174,97 +210,145 @@ namespace webrtc
             dstSize.height(),
             1);
 
-        // todo(kazuki): "glFinish" is used to sync GPU for waiting to copy the texture buffer.
-        // But this command affects graphics performance.
-        glFinish();
+        // Start reading back the pixels into the PBO. The transfer runs asynchronously,
+        // so ConvertRGBToI420 only needs to map the PBO after waiting for the fence.
+        const GLuint pbo = dstTexture->GetPBO();
+        if (pbo != 0)
+        {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+            glBindTexture(GL_TEXTURE_2D, dstName);
+            GetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+
+        // Insert the fence instead of waiting for the copy to finish.
+        // glFlush is needed to make the fence visible from the other contexts.
+        dstTexture->SetSync(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        glFlush();
 
         return true;
     }
 
-    void OpenGLGraphicsDevice::ReleaseTexture(OpenGLTexture2D* texture)
+    bool OpenGLGraphicsDevice::WaitSync(const ITexture2D* texture, uint64_t nsTimeout)
     {
-        if (!OpenGLContext::CurrentContext())
-            contexts_.push_back(OpenGLContext::CreateGLContext(mainContext_.get()));
-        texture->Release();
-    }
+        EnsureCurrentContext();
 
-    void GetTexImage(GLenum target, GLint level, GLenum format, GLenum type, void* pixels)
-    {
-#if SUPPORT_OPENGL_CORE
-        glGetTexImage(target, level, format, type, pixels);
-#elif SUPPORT_OPENGL_ES
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo[0]);
+        const OpenGLTexture2D* glTexture = static_cast<const OpenGLTexture2D*>(texture);
+        GLsync sync = glTexture->GetSync();
+        if (!sync)
+            return true;
 
-        int width = 0;
-        int height = 0;
-        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
-        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+        GLenum result = glClientWaitSync(sync, 0, nsTimeout);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+        {
+            RTC_LOG(LS_INFO) << "glClientWaitSync failed. result:" << result;
+            return false;
+        }
+        return true;
+    }
 
-        GLint tex;
-        glGetIntegerv(GL_TEXTURE_BINDING_2D, &tex);
+    bool OpenGLGraphicsDevice::ResetSync(const ITexture2D* texture)
+    {
+        const OpenGLTexture2D* glTexture = static_cast<const OpenGLTexture2D*>(texture);
+        GLsync sync = glTexture->GetSync();
+        if (!sync)
+            return true;
+
+        // The fence is replaced by the next copy, so only check the status here.
+        GLint status = GL_UNSIGNALED;
+        glGetSynciv(sync, GL_SYNC_STATUS, 1, nullptr, &status);
+        return status == GL_SIGNALED;
+    }
 
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex, 0);
+    bool OpenGLGraphicsDevice::WaitIdleForTest()
+    {
+        glFinish();
+        return true;
+    }
 
-        // read pixels from framebuffer to PBO
-        glReadBuffer(GL_COLOR_ATTACHMENT0);
-        glReadPixels(0, 0, width, height, format, type, pixels);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-#endif
+    void OpenGLGraphicsDevice::ReleaseTexture(OpenGLTexture2D* texture)
+    {
+        EnsureCurrentContext();
+        texture->Release();
     }
 
-    rtc::scoped_refptr<webrtc::I420Buffer> OpenGLGraphicsDevice::ConvertRGBToI420(ITexture2D* tex)
+    bool OpenGLGraphicsDevice::MapPixelBuffer(
+        ITexture2D* tex, std::function<void(const uint8_t* data, int stride)> func)
     {
-        if (!OpenGLContext::CurrentContext())
-            contexts_.push_back(OpenGLContext::CreateGLContext(mainContext_.get()));
+        EnsureCurrentContext();
 
         OpenGLTexture2D* sourceTex = static_cast<OpenGLTexture2D*>(tex);
-        const GLuint sourceId = reinterpret_cast<uintptr_t>(sourceTex->GetNativeTexturePtrV());
         const GLuint pbo = sourceTex->GetPBO();
-        const GLenum format = GL_RGBA;
-        const uint32_t width = sourceTex->GetWidth();
-        const uint32_t height = sourceTex->GetHeight();
         const uint32_t bufferSize = sourceTex->GetBufferSize();
-        byte* data = sourceTex->GetBuffer();
+        RTC_DCHECK(pbo);
 
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
-        glBindTexture(GL_TEXTURE_2D, sourceId);
-
-        GetTexImage(GL_TEXTURE_2D, 0, format, GL_UNSIGNED_BYTE, nullptr);
+        // The pixels have been read back into the PBO when copying the texture.
+        // The lost fence must not block the encoder thread, so the conversion fails.
+        using namespace std::chrono_literals;
+        const std::chrono::nanoseconds timeout(30ms); // 30ms
+        if (!WaitSync(sourceTex, timeout.count()))
+        {
+            RTC_LOG(LS_INFO) << "WaitSync failed.";
+            return false;
+        }
 
-        // Send PBO to main memory
-        GLubyte* pboPtr = static_cast<GLubyte*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bufferSize, GL_MAP_READ_BIT));
-        if (pboPtr)
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+        const uint8_t* data =
+            static_cast<const uint8_t*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bufferSize, GL_MAP_READ_BIT));
+        if (!data)
         {
-            std::memcpy(data, pboPtr, bufferSize);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            RTC_LOG(LS_INFO) << "glMapBufferRange failed.";
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            return false;
         }
-        glBindTexture(GL_TEXTURE_2D, 0);
+        func(data, static_cast<int>(sourceTex->GetPitch()));
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
         glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return true;
+    }
 
-        // RGBA -> I420
-        rtc::scoped_refptr<webrtc::I420Buffer> i420_buffer = webrtc::I420Buffer::Create(width, height);
-        libyuv::ABGRToI420(
-            static_cast<uint8_t*>(data),
-            width * 4,
-            i420_buffer->MutableDataY(),
-            width,
-            i420_buffer->MutableDataU(),
-            (width + 1) / 2,
-            i420_buffer->MutableDataV(),
-            (width + 1) / 2,
-            width,
-            height);
+    rtc::scoped_refptr<webrtc::I420Buffer> OpenGLGraphicsDevice::ConvertRGBToI420(ITexture2D* tex)
+    {
+        const int width = static_cast<int>(tex->GetWidth());
+        const int height = static_cast<int>(tex->GetHeight());
+
+        // RGBA -> I420 directly from the mapped memory.
+        rtc::scoped_refptr<webrtc::I420Buffer> i420_buffer;
+        MapPixelBuffer(
+            tex,
+            [&](const uint8_t* data, int stride)
+            {
+                RGBToI420Converter converter(GetWorkerThreadPool());
+                i420_buffer = converter.Convert(libyuv::ABGRToI420, data, stride, width, height);
+            });
         return i420_buffer;
     }
 
+    rtc::scoped_refptr<webrtc::NV12Buffer> OpenGLGraphicsDevice::ConvertRGBToNV12(ITexture2D* tex)
+    {
+        const int width = static_cast<int>(tex->GetWidth());
+        const int height = static_cast<int>(tex->GetHeight());
+
+        // RGBA -> NV12 directly from the mapped memory.
+        rtc::scoped_refptr<webrtc::NV12Buffer> nv12_buffer;
+        MapPixelBuffer(
+            tex,
+            [&](const uint8_t* data, int stride)
+            {
+                RGBToI420Converter converter(GetWorkerThreadPool());
+                nv12_buffer = converter.ConvertToNV12(libyuv::ABGRToNV12, data, stride, width, height);
+            });
+        return nv12_buffer;
+    }
+
     std::unique_ptr<GpuMemoryBufferHandle> OpenGLGraphicsDevice::Map(ITexture2D* texture)
     {
 #if CUDA_PLATFORM
         if (!IsCudaSupport())
             return nullptr;
 
-        if (!OpenGLContext::CurrentContext())
-            contexts_.push_back(OpenGLContext::CreateGLContext(mainContext_.get()));
+        EnsureCurrentContext();
 
         OpenGLTexture2D* glTexture2D = static_cast<OpenGLTexture2D*>(texture);
 
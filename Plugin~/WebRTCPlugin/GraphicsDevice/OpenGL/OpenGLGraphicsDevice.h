@@ -1,5 +1,8 @@
 #pragma once
 
+#include <functional>
+#include <mutex>
+
 #if SUPPORT_OPENGL_CORE
 #include <glad/gl.h>
 #endif
@@ -34,9 +37,15 @@ namespace webrtc
         ITexture2D*
         CreateCPUReadTextureV(uint32_t width, uint32_t height, UnityRenderingExtTextureFormat textureFormat) override;
         bool CopyResourceV(ITexture2D* dest, ITexture2D* src) override;
+        // The worker thread makes the shared context current.
+        bool CanCopyResourceOnWorkerThread() const override { return true; }
         rtc::scoped_refptr<webrtc::I420Buffer> ConvertRGBToI420(ITexture2D* tex) override;
+        rtc::scoped_refptr<webrtc::NV12Buffer> ConvertRGBToNV12(ITexture2D* tex) override;
         bool CopyResourceFromNativeV(ITexture2D* dest, void* nativeTexturePtr) override;
         std::unique_ptr<GpuMemoryBufferHandle> Map(ITexture2D* texture) override;
+        bool WaitSync(const ITexture2D* texture, uint64_t nsTimeout = 0) override;
+        bool ResetSync(const ITexture2D* texture) override;
+        bool WaitIdleForTest() override;
 
 #if CUDA_PLATFORM
         bool IsCudaSupport() override { return m_isCudaSupport; }
@@ -45,13 +54,19 @@ namespace webrtc
 #endif
 
     private:
-        bool CopyResource(GLuint dstName, GLuint srcName);
+        // Creates the context shared with the main context for the calling thread,
+        // e.g. the worker threads of the encoders. Thread-safe.
+        void EnsureCurrentContext();
+        bool CopyResource(OpenGLTexture2D* dstTexture, GLuint srcName);
         void ReleaseTexture(OpenGLTexture2D* texture);
+        // Maps the pixels read back into the PBO of |tex| and passes them to |func|.
+        bool MapPixelBuffer(ITexture2D* tex, std::function<void(const uint8_t* data, int stride)> func);
 #if CUDA_PLATFORM
         CudaContext m_cudaContext;
         bool m_isCudaSupport;
 #endif
         std::unique_ptr<OpenGLContext> mainContext_;
+        std::mutex contextsMutex_;
         std::vector<std::unique_ptr<OpenGLContext>> contexts_;
     };
 
@@ -18,6 +18,7 @@ namespace webrtc
         : ITexture2D(w, h)
         , m_texture(tex)
         , m_pbo(0)
+        , m_sync(nullptr)
         , m_callback(callback)
     {
         RTC_DCHECK(m_texture);
@@ -36,6 +37,15 @@ namespace webrtc
         {
             glDeleteBuffers(1, &m_pbo);
         }
+
+        SetSync(nullptr);
+    }
+
+    void OpenGLTexture2D::SetSync(GLsync sync)
+    {
+        if (m_sync)
+            glDeleteSync(m_sync);
+        m_sync = sync;
     }
 
     void OpenGLTexture2D::CreatePBO()
@@ -43,14 +53,11 @@ namespace webrtc
         RTC_DCHECK_EQ(m_pbo, 0);
 
         glGenBuffers(1, &m_pbo);
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pbo);
 
         const size_t bufferSize = GetBufferSize();
-        glBufferData(GL_PIXEL_UNPACK_BUFFER, bufferSize, nullptr, GL_DYNAMIC_DRAW);
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
-
-        if (m_buffer.empty())
-            m_buffer.resize(bufferSize);
+        glBufferData(GL_PIXEL_PACK_BUFFER, bufferSize, nullptr, GL_STREAM_READ);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
     }
 } // end namespace webrtc
 } // end namespace unity
\ No newline at end of file
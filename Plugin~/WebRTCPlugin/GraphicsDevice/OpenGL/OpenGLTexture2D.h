@@ -28,18 +28,23 @@ namespace webrtc
         inline void* GetEncodeTexturePtrV() override;
         inline const void* GetEncodeTexturePtrV() const override;
 
+        // The PBO receives the pixels asynchronously when the texture is copied.
         void CreatePBO();
         size_t GetBufferSize() const { return m_width * m_height * 4; }
         size_t GetPitch() const { return m_width * 4; }
-        byte* GetBuffer() { return m_buffer.data(); }
         GLuint GetPBO() const { return m_pbo; }
         GLuint GetTexture() const { return m_texture; }
+
+        // The fence of the last command which writes into the texture.
+        // The previous fence is deleted when the new one is set.
+        void SetSync(GLsync sync);
+        GLsync GetSync() const { return m_sync; }
         void Release();
 
     private:
         GLuint m_texture;
         GLuint m_pbo;
-        std::vector<byte> m_buffer;
+        GLsync m_sync;
         ReleaseOpenGLTextureCallback m_callback;
     };
 
@@ -0,0 +1,148 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "RGBToI420Converter.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    RGBToI420Converter::RGBToI420Converter(WorkerThreadPool* pool)
+        : pool_(pool)
+    {
+    }
+
+    rtc::scoped_refptr<webrtc::I420Buffer> RGBToI420Converter::Convert(
+        ConvertFunc convert, const uint8_t* src, int srcStride, int width, int height)
+    {
+        rtc::scoped_refptr<webrtc::I420Buffer> i420Buffer = webrtc::I420Buffer::Create(width, height);
+        int result = Convert(
+            convert,
+            src,
+            srcStride,
+            i420Buffer->MutableDataY(),
+            i420Buffer->StrideY(),
+            i420Buffer->MutableDataU(),
+            i420Buffer->StrideU(),
+            i420Buffer->MutableDataV(),
+            i420Buffer->StrideV(),
+            width,
+            height);
+        if (result)
+        {
+            RTC_LOG(LS_INFO) << "libyuv conversion to I420 failed. error:" << result;
+            return nullptr;
+        }
+        return i420Buffer;
+    }
+
+    int RGBToI420Converter::Convert(
+        ConvertFunc convert,
+        const uint8_t* src,
+        int srcStride,
+        uint8_t* dstY,
+        int dstStrideY,
+        uint8_t* dstU,
+        int dstStrideU,
+        uint8_t* dstV,
+        int dstStrideV,
+        int width,
+        int height)
+    {
+        return ForEachStripe(
+            height,
+            [&](int y, int rows)
+            {
+                const int chromaY = y / 2;
+                return convert(
+                    src + y * srcStride,
+                    srcStride,
+                    dstY + y * dstStrideY,
+                    dstStrideY,
+                    dstU + chromaY * dstStrideU,
+                    dstStrideU,
+                    dstV + chromaY * dstStrideV,
+                    dstStrideV,
+                    width,
+                    rows);
+            });
+    }
+
+    rtc::scoped_refptr<webrtc::NV12Buffer> RGBToI420Converter::ConvertToNV12(
+        ConvertNV12Func convert, const uint8_t* src, int srcStride, int width, int height)
+    {
+        rtc::scoped_refptr<webrtc::NV12Buffer> nv12Buffer = webrtc::NV12Buffer::Create(width, height);
+        int result = ConvertToNV12(
+            convert,
+            src,
+            srcStride,
+            nv12Buffer->MutableDataY(),
+            nv12Buffer->StrideY(),
+            nv12Buffer->MutableDataUV(),
+            nv12Buffer->StrideUV(),
+            width,
+            height);
+        if (result)
+        {
+            RTC_LOG(LS_INFO) << "libyuv conversion to NV12 failed. error:" << result;
+            return nullptr;
+        }
+        return nv12Buffer;
+    }
+
+    int RGBToI420Converter::ConvertToNV12(
+        ConvertNV12Func convert,
+        const uint8_t* src,
+        int srcStride,
+        uint8_t* dstY,
+        int dstStrideY,
+        uint8_t* dstUV,
+        int dstStrideUV,
+        int width,
+        int height)
+    {
+        return ForEachStripe(
+            height,
+            [&](int y, int rows)
+            {
+                return convert(
+                    src + y * srcStride,
+                    srcStride,
+                    dstY + y * dstStrideY,
+                    dstStrideY,
+                    dstUV + y / 2 * dstStrideUV,
+                    dstStrideUV,
+                    width,
+                    rows);
+            });
+    }
+
+    int RGBToI420Converter::ForEachStripe(int height, std::function<int(int, int)> func)
+    {
+        const int numThreads = pool_ ? static_cast<int>(pool_->numThreads()) : 0;
+        const int stripeCount = std::min(numThreads + 1, height / kMinStripeHeight);
+        if (stripeCount <= 1)
+            return func(0, height);
+
+        // Align the stripe height to the chroma subsampling.
+        const int stripeHeight = ((height + stripeCount - 1) / stripeCount + 1) & ~1;
+        std::atomic<int> result(0);
+        pool_->ParallelFor(
+            stripeCount,
+            [&](int index)
+            {
+                const int y = index * stripeHeight;
+                if (y >= height)
+                    return;
+                const int rows = std::min(stripeHeight, height - y);
+                int ret = func(y, rows);
+                if (ret)
+                    result = ret;
+            });
+        return result;
+    }
+
+} // end namespace webrtc
+} // end namespace unity
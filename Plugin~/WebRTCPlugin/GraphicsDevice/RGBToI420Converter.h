@@ -0,0 +1,92 @@
+#pragma once
+
+#include <functional>
+
+#include <api/video/i420_buffer.h>
+#include <api/video/nv12_buffer.h>
+
+#include "WorkerThreadPool.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    namespace webrtc = ::webrtc;
+
+    // Converts 32bit RGB pixels to I420 or NV12 on the worker threads of |pool|.
+    // The frame is split into row stripes which have even height, so that each
+    // stripe writes the separate rows of the chroma planes.
+    class RGBToI420Converter
+    {
+    public:
+        // The signature of libyuv::ARGBToI420 and libyuv::ABGRToI420.
+        using ConvertFunc = int (*)(
+            const uint8_t* src,
+            int src_stride,
+            uint8_t* dst_y,
+            int dst_stride_y,
+            uint8_t* dst_u,
+            int dst_stride_u,
+            uint8_t* dst_v,
+            int dst_stride_v,
+            int width,
+            int height);
+
+        // The signature of libyuv::ARGBToNV12 and libyuv::ABGRToNV12.
+        using ConvertNV12Func = int (*)(
+            const uint8_t* src,
+            int src_stride,
+            uint8_t* dst_y,
+            int dst_stride_y,
+            uint8_t* dst_uv,
+            int dst_stride_uv,
+            int width,
+            int height);
+
+        // The stripe smaller than this is not worth to dispatch to the other thread.
+        static constexpr int kMinStripeHeight = 64;
+
+        // |pool| must outlive the converter. The conversion runs on the calling thread if |pool| is nullptr.
+        explicit RGBToI420Converter(WorkerThreadPool* pool);
+
+        rtc::scoped_refptr<webrtc::I420Buffer>
+        Convert(ConvertFunc convert, const uint8_t* src, int srcStride, int width, int height);
+
+        // Returns 0 on success like libyuv.
+        int Convert(
+            ConvertFunc convert,
+            const uint8_t* src,
+            int srcStride,
+            uint8_t* dstY,
+            int dstStrideY,
+            uint8_t* dstU,
+            int dstStrideU,
+            uint8_t* dstV,
+            int dstStrideV,
+            int width,
+            int height);
+
+        rtc::scoped_refptr<webrtc::NV12Buffer>
+        ConvertToNV12(ConvertNV12Func convert, const uint8_t* src, int srcStride, int width, int height);
+
+        // Returns 0 on success like libyuv.
+        int ConvertToNV12(
+            ConvertNV12Func convert,
+            const uint8_t* src,
+            int srcStride,
+            uint8_t* dstY,
+            int dstStrideY,
+            uint8_t* dstUV,
+            int dstStrideUV,
+            int width,
+            int height);
+
+    private:
+        // Runs |func| for each stripe of |height| rows. |func| receives the first row and the row count.
+        int ForEachStripe(int height, std::function<int(int, int)> func);
+
+        WorkerThreadPool* const pool_;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,130 @@
+#include "pch.h"
+
+#include <third_party/libyuv/include/libyuv.h>
+
+#include "GpuMemoryBuffer.h"
+#include "GraphicsDevice/RGBToI420Converter.h"
+#include "SoftwareGraphicsDevice.h"
+#include "SoftwareTexture2D.h"
+
+namespace unity
+{
+namespace webrtc
+{
+
+    // Returns true if the byte order of the pixel in memory is R, G, B, A.
+    // libyuv names the formats by the order of the 32bit word (little endian),
+    // so R8G8B8A8 is called "ABGR" and B8G8R8A8 is called "ARGB".
+    static bool IsRGBAOrder(UnityRenderingExtTextureFormat format)
+    {
+        switch (format)
+        {
+        case kUnityRenderingExtFormatR8G8B8A8_SRGB:
+        case kUnityRenderingExtFormatR8G8B8A8_UNorm:
+        case kUnityRenderingExtFormatR8G8B8A8_SNorm:
+        case kUnityRenderingExtFormatR8G8B8A8_UInt:
+        case kUnityRenderingExtFormatR8G8B8A8_SInt:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    SoftwareGraphicsDevice::SoftwareGraphicsDevice(UnityGfxRenderer renderer, ProfilerMarkerFactory* profiler)
+        : IGraphicsDevice(renderer, profiler)
+    {
+    }
+
+    SoftwareGraphicsDevice::~SoftwareGraphicsDevice() { }
+
+    bool SoftwareGraphicsDevice::InitV() { return true; }
+
+    void SoftwareGraphicsDevice::ShutdownV() { }
+
+    ITexture2D*
+    SoftwareGraphicsDevice::CreateDefaultTextureV(uint32_t w, uint32_t h, UnityRenderingExtTextureFormat textureFormat)
+    {
+        return new SoftwareTexture2D(w, h, textureFormat);
+    }
+
+    ITexture2D*
+    SoftwareGraphicsDevice::CreateCPUReadTextureV(uint32_t w, uint32_t h, UnityRenderingExtTextureFormat textureFormat)
+    {
+        // The default texture is already readable from CPU.
+        return new SoftwareTexture2D(w, h, textureFormat);
+    }
+
+    bool SoftwareGraphicsDevice::CopyResourceV(ITexture2D* dest, ITexture2D* src)
+    {
+        SoftwareTexture2D* dstTexture = static_cast<SoftwareTexture2D*>(dest);
+        SoftwareTexture2D* srcTexture = static_cast<SoftwareTexture2D*>(src);
+        if (dstTexture == srcTexture)
+            return false;
+        if (!srcTexture->IsSize(dstTexture->GetWidth(), dstTexture->GetHeight()))
+            return false;
+        return CopyResourceFromNativeV(dest, srcTexture->GetNativeTexturePtrV());
+    }
+
+    bool SoftwareGraphicsDevice::CopyResourceFromNativeV(ITexture2D* dest, NativeTexPtr nativeTexturePtr)
+    {
+        if (!nativeTexturePtr)
+            return false;
+        const SoftwareTextureData* src = static_cast<const SoftwareTextureData*>(nativeTexturePtr);
+        SoftwareTexture2D* dstTexture = static_cast<SoftwareTexture2D*>(dest);
+        if (!src->data || src->data == dstTexture->GetBuffer())
+            return false;
+
+        // Rejects the image which doesn't cover the whole texture.
+        const int pitch = dstTexture->GetPitch();
+        const int height = static_cast<int>(dstTexture->GetHeight());
+        if (src->stride < pitch)
+            return false;
+        if (src->size < static_cast<size_t>(src->stride) * static_cast<size_t>(height - 1) + pitch)
+            return false;
+
+        libyuv::CopyPlane(
+            static_cast<const uint8_t*>(src->data), src->stride, dstTexture->GetBuffer(), pitch, pitch, height);
+        return true;
+    }
+
+    std::unique_ptr<GpuMemoryBufferHandle> SoftwareGraphicsDevice::Map(ITexture2D* texture)
+    {
+        // There is no memory which is shared with hardware encoders.
+        return nullptr;
+    }
+
+    bool SoftwareGraphicsDevice::WaitSync(const ITexture2D* texture, uint64_t nsTimeout)
+    {
+        // All commands are completed on the calling thread.
+        return true;
+    }
+
+    bool SoftwareGraphicsDevice::ResetSync(const ITexture2D* texture) { return true; }
+
+    bool SoftwareGraphicsDevice::WaitIdleForTest() { return true; }
+
+    rtc::scoped_refptr<webrtc::I420Buffer> SoftwareGraphicsDevice::ConvertRGBToI420(ITexture2D* tex)
+    {
+        SoftwareTexture2D* texture = static_cast<SoftwareTexture2D*>(tex);
+        const int width = static_cast<int>(texture->GetWidth());
+        const int height = static_cast<int>(texture->GetHeight());
+
+        // libyuv selects the SIMD implementation (SSSE3/AVX2/NEON) at runtime.
+        auto convert = IsRGBAOrder(texture->GetFormat()) ? libyuv::ABGRToI420 : libyuv::ARGBToI420;
+        return RGBToI420Converter(GetWorkerThreadPool()).Convert(
+            convert, texture->GetBuffer(), static_cast<int>(texture->GetPitch()), width, height);
+    }
+
+    rtc::scoped_refptr<webrtc::NV12Buffer> SoftwareGraphicsDevice::ConvertRGBToNV12(ITexture2D* tex)
+    {
+        SoftwareTexture2D* texture = static_cast<SoftwareTexture2D*>(tex);
+        const int width = static_cast<int>(texture->GetWidth());
+        const int height = static_cast<int>(texture->GetHeight());
+
+        auto convert = IsRGBAOrder(texture->GetFormat()) ? libyuv::ABGRToNV12 : libyuv::ARGBToNV12;
+        return RGBToI420Converter(GetWorkerThreadPool()).ConvertToNV12(
+            convert, texture->GetBuffer(), static_cast<int>(texture->GetPitch()), width, height);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "GraphicsDevice/IGraphicsDevice.h"
+
+namespace unity
+{
+namespace webrtc
+{
+
+    namespace webrtc = ::webrtc;
+
+    // The graphics device which doesn't depend on GPU. All textures are allocated
+    // on host memory, so copying resources is completed synchronously.
+    // This device is used when Unity runs without graphics device
+    // (e.g. batchmode with -nographics option on the server).
+    class SoftwareGraphicsDevice : public IGraphicsDevice
+    {
+    public:
+        SoftwareGraphicsDevice(UnityGfxRenderer renderer, ProfilerMarkerFactory* profiler);
+        virtual ~SoftwareGraphicsDevice() override;
+
+        bool InitV() override;
+        void ShutdownV() override;
+        inline void* GetEncodeDevicePtrV() override;
+
+        ITexture2D*
+        CreateDefaultTextureV(uint32_t w, uint32_t h, UnityRenderingExtTextureFormat textureFormat) override;
+        ITexture2D*
+        CreateCPUReadTextureV(uint32_t w, uint32_t h, UnityRenderingExtTextureFormat textureFormat) override;
+        bool CopyResourceV(ITexture2D* dest, ITexture2D* src) override;
+        bool CanCopyResourceOnWorkerThread() const override { return true; }
+
+        // |nativeTexturePtr| is a SoftwareTextureData which describes the image of
+        // the same size and format as |dest|. The image which is smaller than
+        // |dest| is rejected.
+        bool CopyResourceFromNativeV(ITexture2D* dest, NativeTexPtr nativeTexturePtr) override;
+        std::unique_ptr<GpuMemoryBufferHandle> Map(ITexture2D* texture) override;
+        bool WaitSync(const ITexture2D* texture, uint64_t nsTimeout = 0) override;
+        bool ResetSync(const ITexture2D* texture) override;
+        bool WaitIdleForTest() override;
+        rtc::scoped_refptr<webrtc::I420Buffer> ConvertRGBToI420(ITexture2D* tex) override;
+        rtc::scoped_refptr<webrtc::NV12Buffer> ConvertRGBToNV12(ITexture2D* tex) override;
+
+#if CUDA_PLATFORM
+        bool IsCudaSupport() override { return false; }
+        CUcontext GetCUcontext() override { return nullptr; }
+        NV_ENC_BUFFER_FORMAT GetEncodeBufferFormat() override { return NV_ENC_BUFFER_FORMAT_UNDEFINED; }
+#endif
+    };
+
+    void* SoftwareGraphicsDevice::GetEncodeDevicePtrV() { return nullptr; }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,21 @@
+#include "pch.h"
+
+#include "SoftwareTexture2D.h"
+
+namespace unity
+{
+namespace webrtc
+{
+
+    SoftwareTexture2D::SoftwareTexture2D(uint32_t w, uint32_t h, UnityRenderingExtTextureFormat format)
+        : ITexture2D(w, h)
+        , m_format(format)
+        , m_buffer(static_cast<size_t>(w) * static_cast<size_t>(h) * 4)
+        , m_data { m_buffer.data(), m_buffer.size(), static_cast<int>(w * 4) }
+    {
+    }
+
+    SoftwareTexture2D::~SoftwareTexture2D() { }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+#include <IUnityRenderingExtensions.h>
+
+#include "GraphicsDevice/ITexture2D.h"
+
+namespace unity
+{
+namespace webrtc
+{
+
+    // The native texture pointer of the software graphics device points to this
+    // description of the 32bit-per-pixel image on host memory, never to the pixels
+    // directly. The managed code fills it with Texture2D.GetRawTextureData.
+    struct SoftwareTextureData
+    {
+        const void* data;
+        // The size of |data| in bytes.
+        size_t size;
+        // The bytes between the first pixels of the adjacent rows.
+        int stride;
+    };
+
+    // The texture which is allocated on host memory as the tightly packed
+    // 32bit-per-pixel image.
+    struct SoftwareTexture2D : ITexture2D
+    {
+    public:
+        SoftwareTexture2D(uint32_t w, uint32_t h, UnityRenderingExtTextureFormat format);
+        virtual ~SoftwareTexture2D() override;
+
+        inline void* GetNativeTexturePtrV() override;
+        inline const void* GetNativeTexturePtrV() const override;
+        inline void* GetEncodeTexturePtrV() override;
+        inline const void* GetEncodeTexturePtrV() const override;
+
+        UnityRenderingExtTextureFormat GetFormat() const { return m_format; }
+        size_t GetBufferSize() const { return m_buffer.size(); }
+        int GetPitch() const { return static_cast<int>(m_width * 4); }
+        uint8_t* GetBuffer() { return m_buffer.data(); }
+        const uint8_t* GetBuffer() const { return m_buffer.data(); }
+
+    private:
+        UnityRenderingExtTextureFormat m_format;
+        std::vector<uint8_t> m_buffer;
+        SoftwareTextureData m_data;
+    };
+
+    //---------------------------------------------------------------------------------------------------------------------
+
+    void* SoftwareTexture2D::GetNativeTexturePtrV() { return &m_data; }
+    const void* SoftwareTexture2D::GetNativeTexturePtrV() const { return &m_data; }
+    void* SoftwareTexture2D::GetEncodeTexturePtrV() { return m_buffer.data(); }
+    const void* SoftwareTexture2D::GetEncodeTexturePtrV() const { return m_buffer.data(); }
+
+} // end namespace webrtc
+} // end namespace unity
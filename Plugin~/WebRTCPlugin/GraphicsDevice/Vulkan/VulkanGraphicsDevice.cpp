@@ -1,8 +1,10 @@
 #include "pch.h"
 
 #include <third_party/libyuv/include/libyuv/convert.h>
+#include <third_party/libyuv/include/libyuv/convert_from_argb.h>
 
 #include "GraphicsDevice/GraphicsUtility.h"
+#include "GraphicsDevice/RGBToI420Converter.h"
 #include "UnityVulkanInterfaceFunctions.h"
 #include "VulkanGraphicsDevice.h"
 #include "VulkanTexture2D.h"
@@ -337,11 +339,10 @@ namespace webrtc
         return vkCreateCommandPool(m_device, &poolInfo, m_allocator, &m_commandPool);
     }
 
-    rtc::scoped_refptr<webrtc::I420Buffer> VulkanGraphicsDevice::ConvertRGBToI420(ITexture2D* tex)
+    bool VulkanGraphicsDevice::MapPixelBuffer(
+        ITexture2D* tex, std::function<void(const uint8_t* data, int stride)> func)
     {
         VulkanTexture2D* vulkanTexture = static_cast<VulkanTexture2D*>(tex);
-        const int32_t width = static_cast<int32_t>(tex->GetWidth());
-        const int32_t height = static_cast<int32_t>(tex->GetHeight());
         const VkDeviceMemory dstImageMemory = vulkanTexture->GetTextureImageMemory();
         VkImageSubresource subresource { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0 };
         VkSubresourceLayout subresourceLayout;
@@ -354,27 +355,47 @@ namespace webrtc
         const VkResult result = vkMapMemory(m_device, dstImageMemory, 0, VK_WHOLE_SIZE, 0, &data);
         if (result != VK_SUCCESS)
         {
-            return nullptr;
+            return false;
         }
         std::memcpy(static_cast<void*>(dst.data()), data, dst.size());
 
         vkUnmapMemory(m_device, dstImageMemory);
 
+        func(dst.data(), rowPitch);
+        return true;
+    }
+
+    rtc::scoped_refptr<webrtc::I420Buffer> VulkanGraphicsDevice::ConvertRGBToI420(ITexture2D* tex)
+    {
+        const int32_t width = static_cast<int32_t>(tex->GetWidth());
+        const int32_t height = static_cast<int32_t>(tex->GetHeight());
+
         // convert format to i420
-        rtc::scoped_refptr<webrtc::I420Buffer> i420Buffer = webrtc::I420Buffer::Create(width, height);
-        libyuv::ARGBToI420(
-            dst.data(),
-            rowPitch,
-            i420Buffer->MutableDataY(),
-            i420Buffer->StrideY(),
-            i420Buffer->MutableDataU(),
-            i420Buffer->StrideU(),
-            i420Buffer->MutableDataV(),
-            i420Buffer->StrideV(),
-            width,
-            height);
-
-        return i420Buffer;
+        rtc::scoped_refptr<webrtc::I420Buffer> i420_buffer;
+        MapPixelBuffer(
+            tex,
+            [&](const uint8_t* data, int stride)
+            {
+                RGBToI420Converter converter(GetWorkerThreadPool());
+                i420_buffer = converter.Convert(libyuv::ARGBToI420, data, stride, width, height);
+            });
+        return i420_buffer;
+    }
+
+    rtc::scoped_refptr<webrtc::NV12Buffer> VulkanGraphicsDevice::ConvertRGBToNV12(ITexture2D* tex)
+    {
+        const int32_t width = static_cast<int32_t>(tex->GetWidth());
+        const int32_t height = static_cast<int32_t>(tex->GetHeight());
+
+        rtc::scoped_refptr<webrtc::NV12Buffer> nv12_buffer;
+        MapPixelBuffer(
+            tex,
+            [&](const uint8_t* data, int stride)
+            {
+                RGBToI420Converter converter(GetWorkerThreadPool());
+                nv12_buffer = converter.ConvertToNV12(libyuv::ARGBToNV12, data, stride, width, height);
+            });
+        return nv12_buffer;
     }
 
     std::unique_ptr<GpuMemoryBufferHandle> VulkanGraphicsDevice::Map(ITexture2D* texture)
@@ -486,6 +507,9 @@ namespace webrtc
         VkFence fence = vulkanTexture->GetFence();
 
         VkResult result = vkGetFenceStatus(m_device, fence);
+        // The pool tries the other buffer while the fence is not signaled.
+        if (result == VK_NOT_READY)
+            return false;
         if (result != VK_SUCCESS)
         {
             RTC_LOG(LS_INFO) << "vkGetFenceStatus failed. result:" << result;
@@ -2,6 +2,7 @@
 
 #include <IUnityGraphicsVulkan.h>
 #include <api/video/i420_buffer.h>
+#include <functional>
 #include <memory>
 #include <vulkan/vulkan.h>
 
@@ -58,6 +59,7 @@ namespace webrtc
         bool ResetSync(const ITexture2D* texture) override;
         bool WaitIdleForTest() override;
         rtc::scoped_refptr<I420Buffer> ConvertRGBToI420(ITexture2D* tex) override;
+        rtc::scoped_refptr<NV12Buffer> ConvertRGBToNV12(ITexture2D* tex) override;
 
 #if CUDA_PLATFORM
         bool IsCudaSupport() override { return m_isCudaSupport; }
@@ -66,6 +68,8 @@ namespace webrtc
 #endif
     private:
         VkResult CreateCommandPool();
+        // Maps the image memory of |tex| and passes the pixels to |func|.
+        bool MapPixelBuffer(ITexture2D* tex, std::function<void(const uint8_t* data, int stride)> func);
         static void AccessQueueCallback(int eventID, void* data);
         static VulkanGraphicsDevice* m_graphicsInstance;
         UnityGraphicsVulkan* m_unityVulkan;
@@ -0,0 +1,135 @@
+#include "pch.h"
+
+#include <numeric>
+
+#include <third_party/libyuv/include/libyuv/convert_from.h>
+#include <third_party/libyuv/include/libyuv/scale.h>
+
+#include "I420ScaleConverter.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    static constexpr int kBytesPerPixel = 4;
+
+    int I420ScaleConverter::StripHeight(int srcHeight, int dstHeight)
+    {
+        // The upscaling filter clamps at the edge of each strip, which makes the seams.
+        if (dstHeight >= srcHeight)
+            return dstHeight;
+        // The odd height changes the ratio of the chroma planes from the luma plane.
+        if (srcHeight % 2 != 0 || dstHeight % 2 != 0)
+            return dstHeight;
+        // libyuv steps the source rows in 16.16 fixed point from the top of the
+        // frame. The strip starts at the same position only if the step is exact.
+        if ((static_cast<int64_t>(srcHeight) << 16) % dstHeight != 0)
+            return dstHeight;
+
+        // |step| destination rows are scaled from the whole number of the source rows.
+        const int step = dstHeight / std::gcd(srcHeight, dstHeight);
+        for (int rows = step; rows < dstHeight; rows += step)
+        {
+            const int64_t srcRows = static_cast<int64_t>(rows) * srcHeight / dstHeight;
+            // Even rows keep the chroma rows of the strip aligned.
+            if (rows >= kMinStripHeight && rows % 2 == 0 && srcRows % 2 == 0)
+                return rows;
+        }
+        // No strip for this ratio. Scale the whole frame at once.
+        return dstHeight;
+    }
+
+    int I420ScaleConverter::Convert(
+        const I420BufferInterface& src,
+        uint8_t* dst,
+        int dstStride,
+        int width,
+        int height,
+        bool flipVertical,
+        uint32_t fourcc)
+    {
+        if (!dst || width <= 0 || height <= 0)
+            return -1;
+        if (dstStride == 0)
+            dstStride = width * kBytesPerPixel;
+
+        if (src.width() == width && src.height() == height)
+        {
+            return libyuv::ConvertFromI420(
+                src.DataY(),
+                src.StrideY(),
+                src.DataU(),
+                src.StrideU(),
+                src.DataV(),
+                src.StrideV(),
+                dst,
+                dstStride,
+                width,
+                flipVertical ? -height : height,
+                fourcc);
+        }
+
+        const int stripHeight = StripHeight(src.height(), height);
+        const int chromaWidth = (width + 1) / 2;
+        const int chromaStripHeight = (stripHeight + 1) / 2;
+        const size_t sizeY = static_cast<size_t>(width) * stripHeight;
+        const size_t sizeUV = static_cast<size_t>(chromaWidth) * chromaStripHeight;
+        strip_.resize(sizeY + sizeUV * 2);
+        uint8_t* stripY = strip_.data();
+        uint8_t* stripU = stripY + sizeY;
+        uint8_t* stripV = stripU + sizeUV;
+
+        for (int y = 0; y < height; y += stripHeight)
+        {
+            // The last strip takes the rest of the rows.
+            const int rows = std::min(stripHeight, height - y);
+            const int srcY = static_cast<int>(static_cast<int64_t>(y) * src.height() / height);
+            const int srcEnd = y + rows == height
+                ? src.height()
+                : static_cast<int>(static_cast<int64_t>(y + rows) * src.height() / height);
+            const int srcRows = srcEnd - srcY;
+            const int srcChromaY = srcY / 2;
+
+            int result = libyuv::I420Scale(
+                src.DataY() + static_cast<ptrdiff_t>(srcY) * src.StrideY(),
+                src.StrideY(),
+                src.DataU() + static_cast<ptrdiff_t>(srcChromaY) * src.StrideU(),
+                src.StrideU(),
+                src.DataV() + static_cast<ptrdiff_t>(srcChromaY) * src.StrideV(),
+                src.StrideV(),
+                src.width(),
+                srcRows,
+                stripY,
+                width,
+                stripU,
+                chromaWidth,
+                stripV,
+                chromaWidth,
+                width,
+                rows,
+                libyuv::kFilterBox);
+            if (result != 0)
+                return result;
+
+            // The flipped strip is written from the bottom of |dst|.
+            const int dstY = flipVertical ? height - y - rows : y;
+            result = libyuv::ConvertFromI420(
+                stripY,
+                width,
+                stripU,
+                chromaWidth,
+                stripV,
+                chromaWidth,
+                dst + static_cast<ptrdiff_t>(dstY) * dstStride,
+                dstStride,
+                width,
+                flipVertical ? -rows : rows,
+                fourcc);
+            if (result != 0)
+                return result;
+        }
+        return 0;
+    }
+
+} // end namespace webrtc
+} // end namespace unity
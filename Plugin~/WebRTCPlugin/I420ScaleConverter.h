@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+
+#include <api/video/video_frame_buffer.h>
+
+namespace unity
+{
+namespace webrtc
+{
+    using namespace ::webrtc;
+
+    // Scales the I420 buffer and converts it to the packed RGB format strip by
+    // strip, instead of scaling the whole frame to the temporary I420 frame
+    // first. The strip stays in the cache until it is converted, and the strip
+    // buffer is kept between the calls, so the steady state does not allocate.
+    // The frame is split only when each strip is scaled exactly like the same
+    // rows of the whole frame. The upscaling is done in one pass, because the
+    // bilinear filter reads the rows across the boundary of the strip.
+    // Not thread-safe.
+    class I420ScaleConverter
+    {
+    public:
+        // The minimum number of the destination rows of one strip.
+        static constexpr int kMinStripHeight = 32;
+
+        I420ScaleConverter() = default;
+        I420ScaleConverter(const I420ScaleConverter&) = delete;
+        I420ScaleConverter& operator=(const I420ScaleConverter&) = delete;
+
+        // Writes |src| scaled to |width|x|height| into |dst| in the libyuv |fourcc|
+        // format with 4 bytes per pixel. Returns 0 on success like libyuv.
+        int Convert(
+            const I420BufferInterface& src,
+            uint8_t* dst,
+            int dstStride,
+            int width,
+            int height,
+            bool flipVertical,
+            uint32_t fourcc);
+
+    private:
+        // Returns the number of the destination rows of the strip which
+        // corresponds to the whole number of the even source rows, or
+        // |dstHeight| when the frame cannot be split without changing the result.
+        static int StripHeight(int srcHeight, int dstHeight);
+
+        std::vector<uint8_t> strip_;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
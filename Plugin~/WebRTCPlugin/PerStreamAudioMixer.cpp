@@ -0,0 +1,64 @@
+#include "pch.h"
+
+#include <algorithm>
+
+#include "PerStreamAudioMixer.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    // The format of the silent mixed frame, which DummyAudioDevice requests.
+    static constexpr int kMixingSampleRate = 48000;
+    static constexpr int kFrameLengthMs = 10;
+
+    rtc::scoped_refptr<PerStreamAudioMixer> PerStreamAudioMixer::Create()
+    {
+        return rtc::make_ref_counted<PerStreamAudioMixer>();
+    }
+
+    bool PerStreamAudioMixer::AddSource(Source* source)
+    {
+        RTC_DCHECK(source);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (std::find(sources_.begin(), sources_.end(), source) != sources_.end())
+            return false;
+        sources_.push_back(source);
+        return true;
+    }
+
+    void PerStreamAudioMixer::RemoveSource(Source* source)
+    {
+        RTC_DCHECK(source);
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find(sources_.begin(), sources_.end(), source);
+        if (it != sources_.end())
+            sources_.erase(it);
+    }
+
+    void PerStreamAudioMixer::Mix(size_t number_of_channels, AudioFrame* audio_frame_for_mixing)
+    {
+        RTC_DCHECK(audio_frame_for_mixing);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (Source* source : sources_)
+            {
+                // The preferred sample rate is the rate of the decoder, so the
+                // stream doesn't resample the audio.
+                source->GetAudioFrameWithInfo(source->PreferredSampleRate(), &frame_);
+            }
+        }
+
+        // nullptr makes the muted frame.
+        audio_frame_for_mixing->UpdateFrame(
+            0,
+            nullptr,
+            static_cast<size_t>(kMixingSampleRate * kFrameLengthMs / 1000),
+            kMixingSampleRate,
+            AudioFrame::kNormalSpeech,
+            AudioFrame::kVadUnknown,
+            number_of_channels);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
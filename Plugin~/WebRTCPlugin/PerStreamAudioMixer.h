@@ -0,0 +1,42 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include <api/audio/audio_frame.h>
+#include <api/audio/audio_mixer.h>
+
+namespace unity
+{
+namespace webrtc
+{
+    using namespace ::webrtc;
+
+    // Pulls the audio of each receive stream without mixing them. Pulling the
+    // audio runs the AudioTrackSinkInterface of the stream, which passes the
+    // audio to Unity, but the mixed result is never played. So the streams are
+    // pulled at their own sample rate, and the combining, the limiter and the
+    // resampling of the mixer are skipped. The mixed frame is always silent.
+    class PerStreamAudioMixer : public AudioMixer
+    {
+    public:
+        static rtc::scoped_refptr<PerStreamAudioMixer> Create();
+
+        // AudioMixer
+        bool AddSource(Source* source) override;
+        void RemoveSource(Source* source) override;
+        void Mix(size_t number_of_channels, AudioFrame* audio_frame_for_mixing) override;
+
+    protected:
+        PerStreamAudioMixer() = default;
+        ~PerStreamAudioMixer() override = default;
+
+    private:
+        std::mutex mutex_;
+        std::vector<Source*> sources_;
+        // Reused for all streams, the pulled audio is discarded.
+        AudioFrame frame_;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
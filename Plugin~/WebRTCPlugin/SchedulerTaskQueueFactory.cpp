@@ -0,0 +1,353 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <api/task_queue/task_queue_base.h>
+
+#include "SchedulerTaskQueueFactory.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    // The number of slots of the timer wheel, and the interval of one slot.
+    static constexpr size_t kWheelSize = 256;
+    static constexpr std::chrono::microseconds kTickInterval = std::chrono::milliseconds(1);
+    static constexpr int64_t kNoTimer = std::numeric_limits<int64_t>::max();
+    static constexpr size_t kMaxThreads = 4;
+
+    class SchedulerTaskQueueFactory::Core
+    {
+    public:
+        explicit Core(size_t numThreads);
+        ~Core();
+
+        void PostTimer(std::shared_ptr<Sequence> sequence, absl::AnyInvocable<void() &&> task, TimeDelta delay);
+        void Schedule(std::shared_ptr<Sequence> sequence);
+        size_t numThreads() const { return workers_.size(); }
+
+    private:
+        struct Timer
+        {
+            int64_t dueTick;
+            std::shared_ptr<Sequence> sequence;
+            absl::AnyInvocable<void() &&> task;
+        };
+
+        void TimerLoop();
+        void WorkerLoop();
+        int64_t ToTick(std::chrono::steady_clock::time_point time) const;
+        int64_t FindNextDueTick() const;
+
+        const std::chrono::steady_clock::time_point start_;
+        std::atomic<bool> quit_;
+
+        // Timer wheel. The timer is stored in the slot of |dueTick| modulo |kWheelSize|.
+        std::mutex timerMutex_;
+        std::condition_variable timerCond_;
+        std::array<std::vector<Timer>, kWheelSize> wheel_;
+        size_t timerCount_;
+        // The first tick which has not been expired yet.
+        int64_t currentTick_;
+        int64_t nextDueTick_;
+
+        // The task queues which have the tasks to run.
+        std::mutex readyMutex_;
+        std::condition_variable readyCond_;
+        std::deque<std::shared_ptr<Sequence>> ready_;
+
+        std::thread timerThread_;
+        std::vector<std::thread> workers_;
+    };
+
+    // The task queue which runs the tasks on the worker threads of |Core|.
+    class SchedulerTaskQueueFactory::Sequence : public TaskQueueBase, public std::enable_shared_from_this<Sequence>
+    {
+    public:
+        explicit Sequence(Core* core)
+            : core_(core)
+        {
+        }
+        ~Sequence() override = default;
+
+        void Start(std::shared_ptr<Sequence> self) { self_ = std::move(self); }
+
+        void Delete() override
+        {
+            std::deque<absl::AnyInvocable<void() &&>> tasks;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                deleted_ = true;
+                tasks.swap(tasks_);
+                // Wait for the running task unless it deletes this task queue.
+                if (!IsCurrent())
+                    idle_.wait(lock, [this]() { return !running_; });
+            }
+            // The timers and the workers may still hold the reference.
+            std::shared_ptr<Sequence> self = std::move(self_);
+        }
+
+        void PostTask(absl::AnyInvocable<void() &&> task) override
+        {
+            bool schedule = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (deleted_)
+                    return;
+                tasks_.push_back(std::move(task));
+                if (!scheduled_)
+                    schedule = scheduled_ = true;
+            }
+            if (schedule)
+                core_->Schedule(shared_from_this());
+        }
+
+        void PostDelayedTask(absl::AnyInvocable<void() &&> task, TimeDelta delay) override
+        {
+            if (delay <= TimeDelta::Zero())
+            {
+                PostTask(std::move(task));
+                return;
+            }
+            core_->PostTimer(shared_from_this(), std::move(task), delay);
+        }
+
+        void PostDelayedHighPrecisionTask(absl::AnyInvocable<void() &&> task, TimeDelta delay) override
+        {
+            PostDelayedTask(std::move(task), delay);
+        }
+
+        // Runs the tasks posted so far, and yields the worker to the other task queues.
+        void RunTasks()
+        {
+            CurrentTaskQueueSetter setter(this);
+            size_t count;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                count = tasks_.size();
+                running_ = true;
+            }
+            for (size_t i = 0; i < count; i++)
+            {
+                absl::AnyInvocable<void() &&> task;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (deleted_ || tasks_.empty())
+                        break;
+                    task = std::move(tasks_.front());
+                    tasks_.pop_front();
+                }
+                std::move(task)();
+            }
+
+            bool reschedule;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                running_ = false;
+                reschedule = !deleted_ && !tasks_.empty();
+                scheduled_ = reschedule;
+            }
+            idle_.notify_all();
+            if (reschedule)
+                core_->Schedule(shared_from_this());
+        }
+
+    private:
+        Core* const core_;
+        // Keeps this task queue alive until Delete is called.
+        std::shared_ptr<Sequence> self_;
+
+        std::mutex mutex_;
+        std::condition_variable idle_;
+        std::deque<absl::AnyInvocable<void() &&>> tasks_;
+        // Queued in |Core::ready_| or running on the worker.
+        bool scheduled_ = false;
+        bool running_ = false;
+        bool deleted_ = false;
+    };
+
+    SchedulerTaskQueueFactory::Core::Core(size_t numThreads)
+        : start_(std::chrono::steady_clock::now())
+        , quit_(false)
+        , timerCount_(0)
+        , currentTick_(0)
+        , nextDueTick_(kNoTimer)
+    {
+        timerThread_ = std::thread(&Core::TimerLoop, this);
+        for (size_t i = 0; i < std::max<size_t>(numThreads, 1); i++)
+            workers_.emplace_back(&Core::WorkerLoop, this);
+    }
+
+    SchedulerTaskQueueFactory::Core::~Core()
+    {
+        quit_ = true;
+        {
+            std::lock_guard<std::mutex> lock(timerMutex_);
+            timerCond_.notify_all();
+        }
+        {
+            std::lock_guard<std::mutex> lock(readyMutex_);
+            readyCond_.notify_all();
+        }
+        timerThread_.join();
+        for (auto& worker : workers_)
+            worker.join();
+        ready_.clear();
+    }
+
+    int64_t SchedulerTaskQueueFactory::Core::ToTick(std::chrono::steady_clock::time_point time) const
+    {
+        return (time - start_) / kTickInterval;
+    }
+
+    void SchedulerTaskQueueFactory::Core::PostTimer(
+        std::shared_ptr<Sequence> sequence, absl::AnyInvocable<void() &&> task, TimeDelta delay)
+    {
+        const auto due = std::chrono::steady_clock::now() + std::chrono::microseconds(delay.us());
+        // Round up not to run the task earlier than the delay.
+        const int64_t dueTick = ToTick(due + kTickInterval - std::chrono::microseconds(1));
+
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        const int64_t tick = std::max(dueTick, currentTick_);
+        wheel_[tick % kWheelSize].push_back({ tick, std::move(sequence), std::move(task) });
+        timerCount_++;
+        if (tick < nextDueTick_)
+        {
+            nextDueTick_ = tick;
+            timerCond_.notify_one();
+        }
+    }
+
+    void SchedulerTaskQueueFactory::Core::Schedule(std::shared_ptr<Sequence> sequence)
+    {
+        {
+            std::lock_guard<std::mutex> lock(readyMutex_);
+            ready_.push_back(std::move(sequence));
+        }
+        readyCond_.notify_one();
+    }
+
+    int64_t SchedulerTaskQueueFactory::Core::FindNextDueTick() const
+    {
+        int64_t next = kNoTimer;
+        for (const auto& slot : wheel_)
+        {
+            for (const Timer& timer : slot)
+                next = std::min(next, timer.dueTick);
+        }
+        return next;
+    }
+
+    void SchedulerTaskQueueFactory::Core::TimerLoop()
+    {
+        std::unique_lock<std::mutex> lock(timerMutex_);
+        while (!quit_)
+        {
+            if (timerCount_ == 0)
+            {
+                timerCond_.wait(lock, [this]() { return quit_ || timerCount_ > 0; });
+                continue;
+            }
+
+            const int64_t nowTick = ToTick(std::chrono::steady_clock::now());
+            if (nextDueTick_ > nowTick)
+            {
+                // Sleep until the earliest timer instead of waking up on every tick.
+                timerCond_.wait_until(lock, start_ + kTickInterval * nextDueTick_);
+                continue;
+            }
+
+            // Expire the slots from the current tick. Visiting every slot once is
+            // enough when more ticks than the wheel size have passed.
+            std::vector<Timer> expired;
+            const int64_t lastTick = std::min(nowTick, currentTick_ + static_cast<int64_t>(kWheelSize) - 1);
+            for (int64_t tick = currentTick_; tick <= lastTick; tick++)
+            {
+                std::vector<Timer>& slot = wheel_[tick % kWheelSize];
+                for (auto it = slot.begin(); it != slot.end();)
+                {
+                    if (it->dueTick <= nowTick)
+                    {
+                        expired.push_back(std::move(*it));
+                        it = slot.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+            }
+            currentTick_ = nowTick + 1;
+            timerCount_ -= expired.size();
+            nextDueTick_ = FindNextDueTick();
+
+            // Keep the order of the due time for the tasks of the same task queue.
+            std::stable_sort(
+                expired.begin(),
+                expired.end(),
+                [](const Timer& a, const Timer& b) { return a.dueTick < b.dueTick; });
+
+            lock.unlock();
+            for (Timer& timer : expired)
+                timer.sequence->PostTask(std::move(timer.task));
+            expired.clear();
+            lock.lock();
+        }
+
+        // Release the task queues which are only referred by the timers.
+        for (auto& slot : wheel_)
+            slot.clear();
+    }
+
+    void SchedulerTaskQueueFactory::Core::WorkerLoop()
+    {
+        while (true)
+        {
+            std::shared_ptr<Sequence> sequence;
+            {
+                std::unique_lock<std::mutex> lock(readyMutex_);
+                readyCond_.wait(lock, [this]() { return quit_ || !ready_.empty(); });
+                if (quit_)
+                    return;
+                sequence = std::move(ready_.front());
+                ready_.pop_front();
+            }
+            sequence->RunTasks();
+        }
+    }
+
+    SchedulerTaskQueueFactory::SchedulerTaskQueueFactory(size_t numThreads)
+        : core_(std::make_unique<Core>(numThreads))
+    {
+    }
+
+    SchedulerTaskQueueFactory::~SchedulerTaskQueueFactory() = default;
+
+    std::unique_ptr<TaskQueueBase, TaskQueueDeleter>
+    SchedulerTaskQueueFactory::CreateTaskQueue(absl::string_view name, Priority priority) const
+    {
+        auto sequence = std::make_shared<Sequence>(core_.get());
+        Sequence* queue = sequence.get();
+        queue->Start(std::move(sequence));
+        return std::unique_ptr<TaskQueueBase, TaskQueueDeleter>(queue);
+    }
+
+    size_t SchedulerTaskQueueFactory::numThreads() const { return core_->numThreads(); }
+
+    size_t SchedulerTaskQueueFactory::DefaultNumThreads()
+    {
+        const size_t concurrency = std::max(std::thread::hardware_concurrency(), 1u);
+        return std::min(std::max<size_t>(concurrency / 4, 1), kMaxThreads);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
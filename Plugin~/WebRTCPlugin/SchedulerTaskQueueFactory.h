@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+
+#include <api/task_queue/task_queue_factory.h>
+
+namespace unity
+{
+namespace webrtc
+{
+    using namespace ::webrtc;
+
+    // Creates the task queues which share one timer thread and a small pool of
+    // worker threads, instead of creating the thread for each task queue.
+    // The tasks of the same task queue run in order and never run concurrently.
+    // Used for the frame schedulers of many video track sources.
+    // All task queues must be deleted before the factory.
+    class SchedulerTaskQueueFactory : public TaskQueueFactory
+    {
+    public:
+        explicit SchedulerTaskQueueFactory(size_t numThreads = DefaultNumThreads());
+        ~SchedulerTaskQueueFactory() override;
+        SchedulerTaskQueueFactory(const SchedulerTaskQueueFactory&) = delete;
+        SchedulerTaskQueueFactory& operator=(const SchedulerTaskQueueFactory&) = delete;
+
+        // |priority| is ignored because all task queues share the same threads.
+        std::unique_ptr<TaskQueueBase, TaskQueueDeleter>
+        CreateTaskQueue(absl::string_view name, Priority priority) const override;
+
+        size_t numThreads() const;
+        static size_t DefaultNumThreads();
+
+    private:
+        class Core;
+        class Sequence;
+        const std::unique_ptr<Core> core_;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
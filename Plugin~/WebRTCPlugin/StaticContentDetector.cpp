@@ -0,0 +1,94 @@
+#include "pch.h"
+
+#include <algorithm>
+
+#include <third_party/libyuv/include/libyuv/compare.h>
+
+#include "StaticContentDetector.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    static constexpr uint32_t kHashSeed = 5381;
+
+    static uint32_t HashPlane(const uint8_t* data, int stride, int x, int y, int width, int height, uint32_t seed)
+    {
+        uint32_t hash = seed;
+        const uint8_t* row = data + static_cast<ptrdiff_t>(y) * stride + x;
+        for (int i = 0; i < height; i++, row += stride)
+            hash = libyuv::HashDjb2(row, static_cast<uint64_t>(width), hash);
+        return hash;
+    }
+
+    uint32_t StaticContentDetector::HashTile(const I420BufferInterface& buffer, int tileX, int tileY) const
+    {
+        const int x = tileX * kTileSize;
+        const int y = tileY * kTileSize;
+        const int width = std::min(kTileSize, width_ - x);
+        const int height = std::min(kTileSize, height_ - y);
+
+        // The chroma planes are included, otherwise the change of only the color is missed.
+        const int chromaX = x / 2;
+        const int chromaY = y / 2;
+        const int chromaWidth = (x + width + 1) / 2 - chromaX;
+        const int chromaHeight = (y + height + 1) / 2 - chromaY;
+
+        uint32_t hash = HashPlane(buffer.DataY(), buffer.StrideY(), x, y, width, height, kHashSeed);
+        hash = HashPlane(buffer.DataU(), buffer.StrideU(), chromaX, chromaY, chromaWidth, chromaHeight, hash);
+        return HashPlane(buffer.DataV(), buffer.StrideV(), chromaX, chromaY, chromaWidth, chromaHeight, hash);
+    }
+
+    ::webrtc::VideoFrame::UpdateRect StaticContentDetector::Detect(const I420BufferInterface& buffer)
+    {
+        const bool resized = buffer.width() != width_ || buffer.height() != height_;
+        if (resized)
+        {
+            width_ = buffer.width();
+            height_ = buffer.height();
+            columns_ = (width_ + kTileSize - 1) / kTileSize;
+            rows_ = (height_ + kTileSize - 1) / kTileSize;
+            hashes_.assign(static_cast<size_t>(columns_) * rows_, 0);
+        }
+
+        int left = columns_;
+        int top = rows_;
+        int right = -1;
+        int bottom = -1;
+        for (int tileY = 0; tileY < rows_; tileY++)
+        {
+            for (int tileX = 0; tileX < columns_; tileX++)
+            {
+                const uint32_t hash = HashTile(buffer, tileX, tileY);
+                uint32_t& previous = hashes_[static_cast<size_t>(tileY) * columns_ + tileX];
+                if (!resized && hash == previous)
+                    continue;
+                previous = hash;
+                left = std::min(left, tileX);
+                top = std::min(top, tileY);
+                right = std::max(right, tileX);
+                bottom = std::max(bottom, tileY);
+            }
+        }
+
+        ::webrtc::VideoFrame::UpdateRect rect { 0, 0, 0, 0 };
+        if (right < 0)
+            return rect;
+        rect.offset_x = left * kTileSize;
+        rect.offset_y = top * kTileSize;
+        rect.width = std::min((right + 1) * kTileSize, width_) - rect.offset_x;
+        rect.height = std::min((bottom + 1) * kTileSize, height_) - rect.offset_y;
+        return rect;
+    }
+
+    void StaticContentDetector::Reset()
+    {
+        width_ = 0;
+        height_ = 0;
+        columns_ = 0;
+        rows_ = 0;
+        hashes_.clear();
+    }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#include <api/video/video_frame.h>
+#include <api/video/video_frame_buffer.h>
+
+namespace unity
+{
+namespace webrtc
+{
+    using namespace ::webrtc;
+
+    // Finds the region which changed since the previous frame by comparing the
+    // hashes of the tiles. Used for the screencast, which is mostly static.
+    // Not thread-safe.
+    class StaticContentDetector
+    {
+    public:
+        // The size of the tile in the luma plane.
+        static constexpr int kTileSize = 64;
+
+        StaticContentDetector() = default;
+        StaticContentDetector(const StaticContentDetector&) = delete;
+        StaticContentDetector& operator=(const StaticContentDetector&) = delete;
+
+        // Returns the bounding box of the changed tiles. Returns the empty rect
+        // when |buffer| is identical to the previous one, and the whole frame
+        // for the first frame or when the size has changed.
+        ::webrtc::VideoFrame::UpdateRect Detect(const I420BufferInterface& buffer);
+
+        // Forgets the previous frame.
+        void Reset();
+
+    private:
+        uint32_t HashTile(const I420BufferInterface& buffer, int tileX, int tileY) const;
+
+        int width_ = 0;
+        int height_ = 0;
+        int columns_ = 0;
+        int rows_ = 0;
+        std::vector<uint32_t> hashes_;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
@@ -1,8 +1,8 @@
 #include "pch.h"
 
-#include <common_audio/include/audio_util.h>
 #include <rtc_base/ref_counted_object.h>
 
+#include "CaptureClock.h"
 #include "UnityAudioTrackSource.h"
 
 namespace unity
@@ -47,31 +47,29 @@ namespace webrtc
         RTC_DCHECK(nNumChannels);
         RTC_DCHECK(nNumFrames);
 
+        // The last sample of |pAudioData| is regarded as captured now.
+        const int64_t nowUs = CaptureClock::GetInstance().CurrentTime().us();
+
         std::lock_guard<std::mutex> lock(_mutex);
 
-        // eg.  80 for 8KHz and 160 for 16kHz
-        size_t nNumFramesFor10ms = static_cast<size_t>(nSampleRate / 100);
-        size_t nNumSamplesFor10ms = nNumFramesFor10ms * nNumChannels;
         constexpr size_t nBitPerSample = sizeof(int16_t) * 8;
-
-        if (_sampleRate != nSampleRate || _numChannels != nNumChannels || _numFrames != nNumFrames)
-        {
-            _sampleRate = nSampleRate;
-            _numChannels = nNumChannels;
-            _numFrames = nNumFrames;
-            _convertedAudioData.clear();
-            _convertedAudioData.reserve(nNumSamplesFor10ms * 20);
-        }
-
-        for (size_t i = 0; i < nNumFrames; i++)
-            _convertedAudioData.push_back(::webrtc::FloatToS16(pAudioData[i]));
-
-        while (_convertedAudioData.size() >= nNumSamplesFor10ms)
-        {
-            for (auto sink : _arrSink)
-                sink->OnData(_convertedAudioData.data(), nBitPerSample, nSampleRate, nNumChannels, nNumFramesFor10ms);
-            _convertedAudioData.erase(_convertedAudioData.begin(), _convertedAudioData.begin() + nNumSamplesFor10ms);
-        }
+        _chunker.Configure(nSampleRate, nNumChannels);
+        const size_t nNumFramesFor10ms = _chunker.framesPerChunk();
+
+        // |pAudioData| is interleaved, all channels of the frames are converted.
+        _chunker.Push(
+            pAudioData,
+            nNumFrames,
+            [&](const int16_t* chunk, size_t remainingFrames)
+            {
+                // The capture time of the first sample of the chunk. WebRTC expects it in the clock of
+                // rtc::TimeMillis and converts it to the NTP time itself, like the capture time of the video frames.
+                const int64_t bufferedUs =
+                    static_cast<int64_t>(nNumFramesFor10ms + remainingFrames) * rtc::kNumMicrosecsPerSec / nSampleRate;
+                const int64_t captureTimeMs = (nowUs - bufferedUs) / rtc::kNumMicrosecsPerMillisec;
+                for (auto sink : _arrSink)
+                    sink->OnData(chunk, nBitPerSample, nSampleRate, nNumChannels, nNumFramesFor10ms, captureTimeMs);
+            });
     }
 
     UnityAudioTrackSource::UnityAudioTrackSource() { }
@@ -5,6 +5,8 @@
 #include <api/media_stream_interface.h>
 #include <pc/local_audio_source.h>
 
+#include "AudioChunker.h"
+
 namespace unity
 {
 namespace webrtc
@@ -30,13 +32,10 @@ namespace webrtc
         ~UnityAudioTrackSource() override;
 
     private:
-        std::vector<int16_t> _convertedAudioData;
+        AudioChunker _chunker;
         std::vector<AudioTrackSinkInterface*> _arrSink;
         std::mutex _mutex;
         cricket::AudioOptions _options;
-        int _sampleRate = 0;
-        size_t _numChannels = 0;
-        size_t _numFrames = 0;
     };
 } // end namespace webrtc
 } // end namespace unity
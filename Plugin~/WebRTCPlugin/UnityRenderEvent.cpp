@@ -1,14 +1,18 @@
 #include "pch.h"
 
+#include <atomic>
+
 #include "Context.h"
 #include "GpuMemoryBufferPool.h"
 #include "GraphicsDevice/GraphicsDevice.h"
 #include "GraphicsDevice/GraphicsUtility.h"
+#include "GraphicsDevice/Software/SoftwareTexture2D.h"
 #include "ProfilerMarkerFactory.h"
 #include "ScopedProfiler.h"
 #include "UnityProfilerInterfaceFunctions.h"
 #include "UnityVideoTrackSource.h"
 #include "VideoFrame.h"
+#include "WorkerThreadPool.h"
 
 #if defined(SUPPORT_VULKAN)
 #include "GraphicsDevice/Vulkan/UnityVulkanInitCallback.h"
@@ -28,16 +32,40 @@ namespace webrtc
     static std::unique_ptr<UnityProfiler> s_UnityProfiler = nullptr;
     static std::unique_ptr<ProfilerMarkerFactory> s_ProfilerMarkerFactory = nullptr;
     static std::map<const uint32_t, std::shared_ptr<UnityVideoRenderer>> s_mapVideoRenderer;
+
+    // The texture data which the batched event converted before the texture update events.
+    struct PreparedTexture
+    {
+        std::shared_ptr<UnityVideoRenderer> renderer;
+        int width;
+        int height;
+        void* data;
+    };
+    static std::map<const uint32_t, PreparedTexture> s_preparedTextures;
     static std::unique_ptr<Clock> s_clock;
 
-    static const size_t kLimitBufferCount = 20;
-    static constexpr TimeDelta kStaleFrameLimit = TimeDelta::Seconds(10);
     static const UnityProfilerMarkerDesc* s_MarkerEncode = nullptr;
     static const UnityProfilerMarkerDesc* s_MarkerDecode = nullptr;
     static std::unique_ptr<IGraphicsDevice> s_gfxDevice;
-    static std::unique_ptr<GpuMemoryBufferPool> s_bufferPool;
+    // Each video source has its own buffer pool so that a source can not starve the others.
+    struct BufferPoolEntry
+    {
+        std::unique_ptr<GpuMemoryBufferPool> pool;
+        TimeDelta staleFrameLimit;
+    };
+    // Keyed by the id of the source, because the address may be reused by the next source.
+    static std::map<uint64_t, BufferPoolEntry> s_bufferPools;
+    // The pools of the removed sources, which are destroyed after all frames are returned.
+    static std::vector<std::unique_ptr<GpuMemoryBufferPool>> s_retiredBufferPools;
+    // The context which the sources of |s_bufferPools| belong to.
+    static const Context* s_bufferPoolsContext = nullptr;
+    // The stale buffers of all pools are released at this interval, not for each source.
+    static constexpr TimeDelta kReleaseStaleBuffersInterval = TimeDelta::Millis(100);
+    static Timestamp s_lastReleaseStaleBuffersTime = Timestamp::MinusInfinity();
     static int s_renderEventID = 0;
     static int s_releaseBuffersEventID = 0;
+    static int s_prewarmBuffersEventID = 0;
+    static int s_batchUpdateTexturesEventID = 0;
 
     IGraphicsDevice* Plugin::GraphicsDevice() { return s_gfxDevice.get(); }
 
@@ -79,13 +107,20 @@ static void UNITY_INTERFACE_API OnGraphicsDeviceEvent(UnityGfxDeviceEventType ev
         /// kUnityGfxDeviceEventInitialize event is occurred twice on Unity Editor.
         /// First time, s_UnityInterfaces return UnityGfxRenderer as kUnityGfxRendererNull.
         /// The actual value of UnityGfxRenderer is returned on second time.
+        /// When Unity runs without graphics device (-nographics option), kUnityGfxRendererNull is kept and
+        /// the software graphics device is used instead.
         UnityGfxRenderer renderer = s_UnityInterfaces->Get<IUnityGraphics>()->GetRenderer();
-        if (renderer == kUnityGfxRendererNull)
+        if (renderer == kUnityGfxRendererNull && s_gfxDevice)
             break;
 
         // Reserve eventID range to use for custom plugin events.
-        s_renderEventID = s_UnityInterfaces->Get<IUnityGraphics>()->ReserveEventIDRange(2);
-        s_releaseBuffersEventID = s_renderEventID + 1;
+        if (s_renderEventID == 0)
+        {
+            s_renderEventID = s_UnityInterfaces->Get<IUnityGraphics>()->ReserveEventIDRange(4);
+            s_releaseBuffersEventID = s_renderEventID + 1;
+            s_prewarmBuffersEventID = s_renderEventID + 2;
+            s_batchUpdateTexturesEventID = s_renderEventID + 3;
+        }
 
 #if defined(SUPPORT_VULKAN)
         if (renderer == kUnityGfxRendererVulkan)
@@ -117,22 +152,38 @@ static void UNITY_INTERFACE_API OnGraphicsDeviceEvent(UnityGfxDeviceEventType ev
 
             vulkan->ConfigureEvent(s_renderEventID, &encodeEventConfig);
             vulkan->ConfigureEvent(s_releaseBuffersEventID, &releaseBufferEventConfig);
+            vulkan->ConfigureEvent(s_prewarmBuffersEventID, &encodeEventConfig);
+
+            // Only the CPU converts the frames, the command buffers are not touched.
+            UnityVulkanPluginEventConfig batchUpdateTexturesEventConfig;
+            batchUpdateTexturesEventConfig.graphicsQueueAccess = kUnityVulkanGraphicsQueueAccess_DontCare;
+            batchUpdateTexturesEventConfig.renderPassPrecondition = kUnityVulkanRenderPass_DontCare;
+            batchUpdateTexturesEventConfig.flags = 0;
+            vulkan->ConfigureEvent(s_batchUpdateTexturesEventID, &batchUpdateTexturesEventConfig);
         }
 #endif
+        // Replace the software graphics device which is created on the first time.
+        // Release buffers before graphics device because buffers depends on the device.
+        s_bufferPools.clear();
+        s_retiredBufferPools.clear();
+        if (s_gfxDevice)
+            s_gfxDevice->ShutdownV();
+
         s_gfxDevice.reset(GraphicsDevice::GetInstance().Init(s_UnityInterfaces, s_ProfilerMarkerFactory.get()));
         if (s_gfxDevice)
         {
             s_gfxDevice->InitV();
         }
-        s_bufferPool = std::make_unique<GpuMemoryBufferPool>(s_gfxDevice.get(), s_clock.get());
         break;
     }
     case kUnityGfxDeviceEventShutdown:
     {
         // Release buffers before graphics device because buffers depends on the device.
-        s_bufferPool = nullptr;
+        s_bufferPools.clear();
+        s_retiredBufferPools.clear();
 
         s_mapVideoRenderer.clear();
+        s_preparedTextures.clear();
 
         if (s_gfxDevice)
         {
@@ -232,13 +283,102 @@ void PluginUnload() { OnGraphicsDeviceEvent(kUnityGfxDeviceEventShutdown); }
 // CommandBuffer.IssuePluginEventAndData method pass data packed by this format.
 struct EncodeData
 {
+    // The pixels on host memory instead of the texture when Unity runs without graphics device.
     void* texture;
     UnityVideoTrackSource* source;
     int width;
     int height;
     UnityRenderingExtTextureFormat format;
+    // The size in bytes and the row stride of the pixels. Used only without graphics device.
+    int dataSize;
+    int stride;
+};
+
+// Data format used by the managed code to update the textures of the video renderers.
+struct TextureUpdateData
+{
+    uint32_t rendererId;
+    int width;
+    int height;
+    UnityRenderingExtTextureFormat format;
+};
+
+struct BatchUpdateTexturesData
+{
+    TextureUpdateData* textures;
+    int count;
+    // Set when the event has finished reading the data, so that the managed code can reuse the buffer.
+    int32_t consumed;
+};
+
+// Data format used by the managed code to allocate buffers before streaming.
+struct PrewarmBuffersData
+{
+    UnityVideoTrackSource* source;
+    int width;
+    int height;
+    UnityRenderingExtTextureFormat format;
+    int count;
+    // Set when the event has finished reading the data, so that the managed code can reuse the buffer.
+    int32_t consumed;
 };
 
+static GpuMemoryBufferPool* GetOrCreateBufferPool(const UnityVideoTrackSource* source)
+{
+    BufferPoolEntry& entry = s_bufferPools[source->id()];
+    if (!entry.pool)
+        entry.pool = std::make_unique<GpuMemoryBufferPool>(s_gfxDevice.get(), s_clock.get());
+    entry.pool->SetMaxBufferCount(source->maxBufferCount());
+    entry.staleFrameLimit = source->staleFrameLimit();
+    return entry.pool.get();
+}
+
+// Moves the pools of the removed sources to |s_retiredBufferPools|.
+// Called with the lock of |s_context|.
+static void RetireBufferPools()
+{
+    if (s_bufferPoolsContext != s_context)
+    {
+        // The sources of the previous context are gone.
+        for (auto& pair : s_bufferPools)
+            s_retiredBufferPools.push_back(std::move(pair.second.pool));
+        s_bufferPools.clear();
+        s_bufferPoolsContext = s_context;
+    }
+    for (uint64_t id : s_context->TakeRemovedVideoSourceIds())
+    {
+        auto it = s_bufferPools.find(id);
+        if (it == s_bufferPools.end())
+            continue;
+        s_retiredBufferPools.push_back(std::move(it->second.pool));
+        s_bufferPools.erase(it);
+    }
+}
+
+// Releases stale buffers of all pools. The retired pool is destroyed after all
+// frames which refer to the pool are returned.
+static void ReleaseStaleBuffers(Timestamp timestamp)
+{
+    // Called for each source, so the pools are walked only once in the interval.
+    if (timestamp - s_lastReleaseStaleBuffersTime < kReleaseStaleBuffersInterval)
+        return;
+    s_lastReleaseStaleBuffersTime = timestamp;
+
+    for (auto& pair : s_bufferPools)
+        pair.second.pool->ReleaseStaleBuffers(timestamp, pair.second.staleFrameLimit);
+
+    auto it = s_retiredBufferPools.begin();
+    while (it != s_retiredBufferPools.end())
+    {
+        GpuMemoryBufferPool* pool = it->get();
+        pool->ReleaseStaleBuffers(Timestamp::PlusInfinity(), TimeDelta::Zero());
+        if (pool->bufferCount() == 0)
+            it = s_retiredBufferPools.erase(it);
+        else
+            ++it;
+    }
+}
+
 // Notice: When DebugLog is used in a method called from RenderingThread,
 // it hangs when attempting to leave PlayMode and re-enter PlayMode.
 // So, we comment out `DebugLog`.
@@ -261,6 +401,8 @@ static void UNITY_INTERFACE_API OnRenderEvent(int eventID, void* data)
     RTC_DCHECK_GT(encodeData->width, 0);
     RTC_DCHECK_GT(encodeData->height, 0);
 
+    RetireBufferPools();
+
     UnityVideoTrackSource* source = encodeData->source;
     if (!s_context->ExistsRefPtr(source))
         return;
@@ -270,16 +412,28 @@ static void UNITY_INTERFACE_API OnRenderEvent(int eventID, void* data)
     void* ptr = GraphicsUtility::TextureHandleToNativeGraphicsPtr(encodeData->texture, device, gfxRenderer);
     unity::webrtc::Size size(encodeData->width, encodeData->height);
 
-    if (s_bufferPool->bufferCount() < kLimitBufferCount)
+    // The software graphics device copies the frame in CreateFrame, so the data can live on the stack.
+    SoftwareTextureData textureData {};
+    if (gfxRenderer == kUnityGfxRendererNull)
+    {
+        if (encodeData->dataSize <= 0 || encodeData->stride <= 0)
+            return;
+        textureData = { encodeData->texture, static_cast<size_t>(encodeData->dataSize), encodeData->stride };
+        ptr = &textureData;
+    }
+
     {
         std::unique_ptr<const ScopedProfiler> profiler;
         if (s_ProfilerMarkerFactory)
             profiler = s_ProfilerMarkerFactory->CreateScopedProfiler(*s_MarkerEncode);
 
-        auto frame = s_bufferPool->CreateFrame(ptr, size, encodeData->format, timestamp);
-        source->OnFrameCaptured(std::move(frame));
+        // The frame is dropped when the pool of the source reaches the limit.
+        GpuMemoryBufferPool* pool = GetOrCreateBufferPool(source);
+        auto frame = pool->CreateFrame(ptr, size, encodeData->format, timestamp);
+        if (frame)
+            source->OnFrameCaptured(std::move(frame));
     }
-    s_bufferPool->ReleaseStaleBuffers(timestamp, kStaleFrameLimit);
+    ReleaseStaleBuffers(timestamp);
 }
 
 static void UNITY_INTERFACE_API OnReleaseBuffers(int eventID, void* data)
@@ -287,8 +441,49 @@ static void UNITY_INTERFACE_API OnReleaseBuffers(int eventID, void* data)
     if (eventID != s_releaseBuffersEventID)
         return;
     // Release all buffers.
-    if (s_bufferPool)
-        s_bufferPool->ReleaseStaleBuffers(Timestamp::PlusInfinity(), kStaleFrameLimit);
+    for (auto& pair : s_bufferPools)
+        pair.second.pool->ReleaseStaleBuffers(Timestamp::PlusInfinity(), TimeDelta::Zero());
+    for (auto& pool : s_retiredBufferPools)
+        pool->ReleaseStaleBuffers(Timestamp::PlusInfinity(), TimeDelta::Zero());
+}
+
+static void PrewarmBuffers(const PrewarmBuffersData* prewarmData)
+{
+    if (!s_context)
+        return;
+    if (!ContextManager::GetInstance()->Exists(s_context))
+        return;
+    std::unique_lock<std::mutex> lock(s_context->mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+        return;
+
+    RTC_DCHECK(prewarmData->source);
+    RTC_DCHECK_GT(prewarmData->width, 0);
+    RTC_DCHECK_GT(prewarmData->height, 0);
+    RTC_DCHECK_GE(prewarmData->count, 0);
+
+    RetireBufferPools();
+
+    UnityVideoTrackSource* source = prewarmData->source;
+    if (!s_context->ExistsRefPtr(source))
+        return;
+    unity::webrtc::Size size(prewarmData->width, prewarmData->height);
+    GpuMemoryBufferPool* pool = GetOrCreateBufferPool(source);
+    pool->Prewarm(size, prewarmData->format, static_cast<size_t>(prewarmData->count));
+}
+
+static void UNITY_INTERFACE_API OnPrewarmBuffers(int eventID, void* data)
+{
+    if (eventID != s_prewarmBuffersEventID)
+        return;
+
+    PrewarmBuffersData* prewarmData = static_cast<PrewarmBuffersData*>(data);
+    RTC_DCHECK(prewarmData);
+    PrewarmBuffers(prewarmData);
+
+    // The managed code overwrites the data after this.
+    std::atomic_thread_fence(std::memory_order_release);
+    prewarmData->consumed = 1;
 }
 
 extern "C" UnityRenderingEventAndData UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetRenderEventFunc(Context* context)
@@ -306,18 +501,130 @@ extern "C" UnityRenderingEventAndData UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API
 
 extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetReleaseBuffersEventID() { return s_releaseBuffersEventID; }
 
+extern "C" UnityRenderingEventAndData UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetPrewarmBuffersFunc(Context* context)
+{
+    s_context = context;
+    return OnPrewarmBuffers;
+}
+
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetPrewarmBuffersEventID() { return s_prewarmBuffersEventID; }
+
+static void BatchUpdateTextures(const BatchUpdateTexturesData* batchData)
+{
+    // The texture update events of the previous batch were not issued for these
+    // renderers, e.g. their textures were destroyed. Don't keep the renderers alive.
+    s_preparedTextures.clear();
+
+    if (!s_context)
+        return;
+    if (!s_gfxDevice)
+        return;
+    if (!ContextManager::GetInstance()->Exists(s_context))
+        return;
+
+    RTC_DCHECK_GE(batchData->count, 0);
+
+    std::vector<const TextureUpdateData*> textures;
+    std::vector<std::shared_ptr<UnityVideoRenderer>> renderers;
+    {
+        // Look up all renderers with one lock.
+        std::unique_lock<std::mutex> lock(s_context->mutex, std::try_to_lock);
+        if (!lock.owns_lock())
+            return;
+        textures.reserve(batchData->count);
+        renderers.reserve(batchData->count);
+        for (int i = 0; i < batchData->count; i++)
+        {
+            const TextureUpdateData& texture = batchData->textures[i];
+            auto renderer = s_context->GetVideoRenderer(texture.rendererId);
+            if (renderer == nullptr)
+                continue;
+            textures.push_back(&texture);
+            renderers.push_back(std::move(renderer));
+        }
+    }
+
+    std::vector<void*> results(renderers.size(), nullptr);
+    {
+        std::unique_ptr<const ScopedProfiler> profiler;
+        if (s_ProfilerMarkerFactory)
+            profiler = s_ProfilerMarkerFactory->CreateScopedProfiler(*s_MarkerDecode);
+
+        // Each renderer converts its own frame into its own buffer.
+        s_gfxDevice->GetWorkerThreadPool()->ParallelFor(
+            static_cast<int>(renderers.size()),
+            [&](int index)
+            {
+                const TextureUpdateData* texture = textures[index];
+                results[index] = renderers[index]->ConvertVideoFrameToTextureAndWriteToBuffer(
+                    texture->width, texture->height, ConvertTextureFormat(texture->format));
+            });
+    }
+
+    for (size_t i = 0; i < renderers.size(); i++)
+    {
+        const TextureUpdateData* texture = textures[i];
+        s_preparedTextures[texture->rendererId] = {
+            std::move(renderers[i]), texture->width, texture->height, results[i]
+        };
+    }
+}
+
+// Converts the frames of many renderers at once on the worker threads, before
+// the texture update events of the renderers which are issued after this event.
+static void UNITY_INTERFACE_API OnBatchUpdateTextures(int eventID, void* data)
+{
+    if (eventID != s_batchUpdateTexturesEventID)
+        return;
+
+    BatchUpdateTexturesData* batchData = static_cast<BatchUpdateTexturesData*>(data);
+    RTC_DCHECK(batchData);
+    BatchUpdateTextures(batchData);
+
+    // The managed code overwrites the data after this.
+    std::atomic_thread_fence(std::memory_order_release);
+    batchData->consumed = 1;
+}
+
+// Sets the texture data which OnBatchUpdateTextures has converted for |params|.
+// Returns false if the batch has not taken the frame of the renderer.
+static bool TakePreparedTexture(UnityRenderingExtTextureUpdateParamsV2* params)
+{
+    auto it = s_preparedTextures.find(params->userData);
+    if (it == s_preparedTextures.end())
+        return false;
+    PreparedTexture prepared = std::move(it->second);
+    s_preparedTextures.erase(it);
+    // The batch has already taken the frame for the other size, so converting
+    // again would write no frame. Skips the update until the next frame.
+    if (prepared.width != static_cast<int>(params->width) || prepared.height != static_cast<int>(params->height))
+    {
+        params->texData = nullptr;
+        return true;
+    }
+    params->texData = prepared.data;
+    s_mapVideoRenderer[params->userData] = std::move(prepared.renderer);
+    return true;
+}
+
 static void UNITY_INTERFACE_API TextureUpdateCallback(int eventID, void* data)
 {
     if (!s_context)
         return;
     if (!ContextManager::GetInstance()->Exists(s_context))
         return;
+
+    auto event = static_cast<UnityRenderingExtEventType>(eventID);
+
+    // The renderer is already held, so the lock of the context is not needed.
+    if (event == kUnityRenderingExtEventUpdateTextureBeginV2 &&
+        TakePreparedTexture(reinterpret_cast<UnityRenderingExtTextureUpdateParamsV2*>(data)))
+        return;
+
     std::unique_lock<std::mutex> lock(s_context->mutex, std::try_to_lock);
     if (!lock.owns_lock())
         return;
 
-    auto event = static_cast<UnityRenderingExtEventType>(eventID);
-
     if (event == kUnityRenderingExtEventUpdateTextureBeginV2)
     {
         auto params = reinterpret_cast<UnityRenderingExtTextureUpdateParamsV2*>(data);
@@ -350,3 +657,15 @@ extern "C" UnityRenderingEventAndData UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API
     s_context = context;
     return TextureUpdateCallback;
 }
+
+extern "C" UnityRenderingEventAndData UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API
+GetBatchUpdateTexturesFunc(Context* context)
+{
+    s_context = context;
+    return OnBatchUpdateTextures;
+}
+
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetBatchUpdateTexturesEventID()
+{
+    return s_batchUpdateTexturesEventID;
+}
@@ -1,6 +1,9 @@
 #include "pch.h"
 
-#include <api/video/i420_buffer.h>
+#include <limits>
+#include <thread>
+
+#include <rtc_base/time_utils.h>
 
 #include "UnityVideoRenderer.h"
 
@@ -9,69 +12,151 @@ namespace unity
 namespace webrtc
 {
 
+    // The interval of the texture updates until it is measured.
+    static constexpr int64_t kDefaultUpdateIntervalUs = rtc::kNumMicrosecsPerSec / 60;
+
     UnityVideoRenderer::UnityVideoRenderer(uint32_t id, DelegateVideoFrameResize callback, bool needFlipVertical)
-        : m_id(id)
-        , m_last_renderered_timestamp(0)
-        , m_timestamp(0)
+        : m_head(0)
+        , m_tail(0)
+        , m_heldPosition(std::numeric_limits<uint64_t>::max())
+        , m_id(id)
+        , m_lastPresentationTimeUs(0)
+        , m_updateIntervalUs(kDefaultUpdateIntervalUs)
+        , m_width(0)
+        , m_height(0)
+        , m_presentedFrameCount(0)
+        , m_earlyFrameCount(0)
+        , m_lateFrameCount(0)
+        , m_droppedFrameCount(0)
         , m_callback(callback)
         , m_needFlipVertical(needFlipVertical)
     {
+        for (uint64_t i = 0; i < kQueueSize; i++)
+        {
+            m_slots[i].sequence = i;
+            m_slots[i].renderTimeUs = 0;
+        }
         DebugLog("Create UnityVideoRenderer Id:%d", id);
     }
 
     UnityVideoRenderer::~UnityVideoRenderer()
     {
         DebugLog("Destroy UnityVideoRenderer Id:%d", m_id);
-        {
-            std::unique_lock<std::mutex> lock(m_mutex);
-        }
     }
 
     void UnityVideoRenderer::OnFrame(const webrtc::VideoFrame& frame)
     {
-        rtc::scoped_refptr<webrtc::VideoFrameBuffer> frame_buffer = frame.video_frame_buffer();
-
-        if (frame_buffer->type() == webrtc::VideoFrameBuffer::Type::kNative)
-        {
-            frame_buffer = frame_buffer->ToI420();
-        }
-        SetFrameBuffer(frame_buffer, frame.timestamp_us());
+        // The native buffer is converted on the render thread only when the
+        // frame is used for the texture, so the frames which are replaced by
+        // the next frame are never converted.
+        SetFrameBuffer(frame.video_frame_buffer(), frame.render_time_ms() * rtc::kNumMicrosecsPerMillisec);
     }
 
     uint32_t UnityVideoRenderer::GetId() { return m_id; }
 
+    uint64_t UnityVideoRenderer::droppedFrameCount() const { return m_droppedFrameCount; }
+
+    VideoRendererStats UnityVideoRenderer::GetStats() const
+    {
+        VideoRendererStats stats;
+        stats.presentedFrames = m_presentedFrameCount.load(std::memory_order_relaxed);
+        stats.earlyFrames = m_earlyFrameCount.load(std::memory_order_relaxed);
+        stats.lateFrames = m_lateFrameCount.load(std::memory_order_relaxed);
+        stats.droppedFrames = m_droppedFrameCount.load(std::memory_order_relaxed);
+        return stats;
+    }
+
     rtc::scoped_refptr<webrtc::VideoFrameBuffer> UnityVideoRenderer::GetFrameBuffer()
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        if (!lock.owns_lock())
+        return GetFrameBuffer(rtc::TimeMicros());
+    }
+
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> UnityVideoRenderer::GetFrameBuffer(int64_t presentationTimeUs)
+    {
+        // Takes the last frame which is due, the earlier due frames are dropped.
+        rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer;
+        int64_t renderTimeUs = 0;
+        // Don't keep the buffers, which the decoder may want to reuse.
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        while (true)
         {
-            return nullptr;
+            Slot& slot = m_slots[head % kQueueSize];
+            if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+            {
+                // The queue is empty, unless the decoder thread has dropped the oldest frame meanwhile.
+                const uint64_t current = m_head.load(std::memory_order_acquire);
+                if (current == head)
+                    break;
+                head = current;
+                continue;
+            }
+            const int64_t slotRenderTimeUs = slot.renderTimeUs.load(std::memory_order_relaxed);
+            if (slotRenderTimeUs > presentationTimeUs)
+            {
+                if (m_heldPosition != head)
+                {
+                    m_heldPosition = head;
+                    m_earlyFrameCount++;
+                }
+                break;
+            }
+            // Fails if the decoder thread has dropped the frame, then |head| is reloaded.
+            if (!m_head.compare_exchange_strong(head, head + 1, std::memory_order_acq_rel))
+                continue;
+            if (buffer)
+                m_droppedFrameCount++;
+            buffer = std::move(slot.buffer);
+            renderTimeUs = slotRenderTimeUs;
+            slot.sequence.store(head + kQueueSize, std::memory_order_release);
+            head++;
         }
-        if (m_last_renderered_timestamp == m_timestamp)
+
+        if (buffer)
         {
-            // skipped copying texture
-            return nullptr;
+            // The frame is late if it should have been shown by the previous update.
+            m_presentedFrameCount++;
+            if (presentationTimeUs - renderTimeUs > m_updateIntervalUs)
+                m_lateFrameCount++;
         }
-        m_last_renderered_timestamp = m_timestamp;
-        return m_frameBuffer;
+        if (m_lastPresentationTimeUs != 0 && presentationTimeUs > m_lastPresentationTimeUs)
+            m_updateIntervalUs = presentationTimeUs - m_lastPresentationTimeUs;
+        m_lastPresentationTimeUs = presentationTimeUs;
+
+        // Returns nullptr to skip copying texture.
+        return buffer;
     }
 
-    void UnityVideoRenderer::SetFrameBuffer(rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer, int64_t timestamp)
+    void UnityVideoRenderer::SetFrameBuffer(rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer, int64_t renderTimeUs)
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        if (!lock.owns_lock())
+        // Notify before queuing the frame, without blocking the render thread.
+        if (m_width != buffer->width() || m_height != buffer->height())
         {
-            return;
+            m_width = buffer->width();
+            m_height = buffer->height();
+            m_callback(this, m_width, m_height);
         }
 
-        if (m_frameBuffer == nullptr || m_frameBuffer->width() != buffer->width() ||
-            m_frameBuffer->height() != buffer->height())
+        Slot& slot = m_slots[m_tail % kQueueSize];
+        rtc::scoped_refptr<webrtc::VideoFrameBuffer> dropped;
+        while (slot.sequence.load(std::memory_order_acquire) != m_tail)
         {
-            m_callback(this, buffer->width(), buffer->height());
+            // The render thread has not taken the frames for a while. The oldest
+            // frame is the least useful one, and it is in the slot to write.
+            uint64_t oldest = m_tail - kQueueSize;
+            if (m_head.compare_exchange_strong(oldest, oldest + 1, std::memory_order_acq_rel))
+            {
+                dropped = std::move(slot.buffer);
+                m_droppedFrameCount++;
+                break;
+            }
+            // The render thread has claimed the oldest frame and is moving it out.
+            std::this_thread::yield();
         }
 
-        m_frameBuffer = buffer;
-        m_timestamp = timestamp;
+        slot.buffer = std::move(buffer);
+        slot.renderTimeUs.store(renderTimeUs, std::memory_order_relaxed);
+        slot.sequence.store(m_tail + 1, std::memory_order_release);
+        m_tail++;
     }
 
     void* UnityVideoRenderer::ConvertVideoFrameToTextureAndWriteToBuffer(int width, int height, libyuv::FourCC format)
@@ -86,37 +171,17 @@ namespace webrtc
         if (frame == nullptr)
             return tempBuffer.data();
 
-        rtc::scoped_refptr<webrtc::I420BufferInterface> i420_buffer;
-        if (width == frame->width() && height == frame->height())
-        {
-            i420_buffer = frame->ToI420();
-        }
-        else
-        {
-            auto temp = webrtc::I420Buffer::Create(width, height);
-            temp->ScaleFrom(*frame->ToI420());
-            i420_buffer = temp;
-        }
+        rtc::scoped_refptr<webrtc::I420BufferInterface> i420_buffer = frame->ToI420();
+        if (!i420_buffer)
+            return tempBuffer.data();
 
-        if (m_needFlipVertical)
-            height = -height;
-
-        int result = libyuv::ConvertFromI420(
-            i420_buffer->DataY(),
-            i420_buffer->StrideY(),
-            i420_buffer->DataU(),
-            i420_buffer->StrideU(),
-            i420_buffer->DataV(),
-            i420_buffer->StrideV(),
-            tempBuffer.data(),
-            0,
-            width,
-            height,
-            static_cast<uint32_t>(format));
+        // Scales and converts in one pass without the temporary scaled frame.
+        int result = m_scaleConverter.Convert(
+            *i420_buffer, tempBuffer.data(), 0, width, height, m_needFlipVertical, static_cast<uint32_t>(format));
 
         if (result)
         {
-            RTC_LOG(LS_INFO) << "libyuv::ConvertFromI420 failed. error:" << result;
+            RTC_LOG(LS_INFO) << "I420ScaleConverter::Convert failed. error:" << result;
         }
         return tempBuffer.data();
     }
@@ -1,11 +1,13 @@
 #pragma once
 
-#include <mutex>
+#include <array>
+#include <atomic>
 
 #include <api/video/video_frame.h>
 #include <api/video/video_sink_interface.h>
 #include <third_party/libyuv/include/libyuv.h>
 
+#include "I420ScaleConverter.h"
 #include "WebRTCPlugin.h"
 
 namespace unity
@@ -15,6 +17,21 @@ namespace webrtc
 
     using namespace ::webrtc;
 
+    struct VideoRendererStats
+    {
+        // The number of frames which were taken for the texture.
+        uint64_t presentedFrames;
+        // The number of frames which were held back at least one texture update
+        // because they were not due yet.
+        uint64_t earlyFrames;
+        // The number of frames which were taken later than one texture update
+        // interval after their render time.
+        uint64_t lateFrames;
+        // The number of frames which were replaced by the later due frame, or
+        // which did not fit in the queue.
+        uint64_t droppedFrames;
+    };
+
     class UnityVideoRenderer : public rtc::VideoSinkInterface<::webrtc::VideoFrame>
     {
     public:
@@ -23,20 +40,64 @@ namespace webrtc
         void OnFrame(const ::webrtc::VideoFrame& frame) override;
 
         uint32_t GetId();
+        // Takes the latest frame which is due at |presentationTimeUs| on the
+        // render thread. Returns nullptr if no new frame is due. Never waits
+        // for the decoder thread.
+        rtc::scoped_refptr<VideoFrameBuffer> GetFrameBuffer(int64_t presentationTimeUs);
+        // Same as above at the current time.
         rtc::scoped_refptr<VideoFrameBuffer> GetFrameBuffer();
-        void SetFrameBuffer(rtc::scoped_refptr<VideoFrameBuffer> buffer, int64_t timestamp);
+        // Queues the frame on the decoder thread. |renderTimeUs| is the time
+        // when the frame should be shown. The oldest frame is dropped when the
+        // queue is full, so that the render thread always gets the newest one.
+        // Yields only while the render thread is moving out that oldest frame.
+        void SetFrameBuffer(rtc::scoped_refptr<VideoFrameBuffer> buffer, int64_t renderTimeUs);
 
         // used in UnityRenderingExtEventUpdateTexture
         // called on RenderThread
         void* ConvertVideoFrameToTextureAndWriteToBuffer(int width, int height, libyuv::FourCC format);
 
+        // The number of frames which were never converted for the texture.
+        uint64_t droppedFrameCount() const;
+
+        VideoRendererStats GetStats() const;
+
+        // The number of frames which can wait for their render time.
+        static constexpr uint32_t kQueueSize = 8;
+
     private:
+        struct Slot
+        {
+            // |position| + 1 while the slot holds the frame at |position|, and
+            // |position| + kQueueSize after the frame is taken.
+            std::atomic<uint64_t> sequence;
+            // Atomic because the render thread reads it before it claims the slot.
+            std::atomic<int64_t> renderTimeUs;
+            rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer;
+        };
+
+        // Lock-free queue from the decoder thread to the render thread, ordered
+        // by the arrival. Only the decoder thread advances |m_tail|. Both threads
+        // claim the oldest frame by advancing |m_head| with compare-and-swap,
+        // the decoder thread only when the queue is full.
+        std::array<Slot, kQueueSize> m_slots;
+        std::atomic<uint64_t> m_head;
+        uint64_t m_tail;
+        // The position of the frame which was counted as early. Used on the render thread.
+        uint64_t m_heldPosition;
+
         uint32_t m_id;
-        std::mutex m_mutex;
         std::vector<uint8_t> tempBuffer;
-        rtc::scoped_refptr<webrtc::VideoFrameBuffer> m_frameBuffer;
-        int64_t m_last_renderered_timestamp;
-        std::atomic<int64_t> m_timestamp;
+        // Used on the render thread.
+        I420ScaleConverter m_scaleConverter;
+        int64_t m_lastPresentationTimeUs;
+        int64_t m_updateIntervalUs;
+        // The size of the last published frame. Used on the decoder thread.
+        int m_width;
+        int m_height;
+        std::atomic<uint64_t> m_presentedFrameCount;
+        std::atomic<uint64_t> m_earlyFrameCount;
+        std::atomic<uint64_t> m_lateFrameCount;
+        std::atomic<uint64_t> m_droppedFrameCount;
         DelegateVideoFrameResize m_callback;
         bool m_needFlipVertical;
     };
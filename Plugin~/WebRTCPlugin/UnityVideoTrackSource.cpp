@@ -1,5 +1,7 @@
 #include "pch.h"
 
+#include "CaptureClock.h"
+#include "GpuMemoryBufferPool.h"
 #include "UnityVideoTrackSource.h"
 #include "VideoFrameAdapter.h"
 #include "VideoFrameScheduler.h"
@@ -8,6 +10,9 @@ namespace unity
 {
 namespace webrtc
 {
+    // The static screencast is still delivered at this interval, so that the
+    // receiver does not regard the stream as frozen.
+    constexpr TimeDelta kMaxStaticFrameInterval = TimeDelta::Seconds(1);
 
     rtc::scoped_refptr<UnityVideoTrackSource> UnityVideoTrackSource::Create(
         bool is_screencast, absl::optional<bool> needs_denoising, TaskQueueFactory* taskQueueFactory)
@@ -15,11 +20,24 @@ namespace webrtc
         return rtc::make_ref_counted<UnityVideoTrackSource>(is_screencast, needs_denoising, taskQueueFactory);
     }
 
+    // The id of the last created source.
+    static std::atomic<uint64_t> s_lastSourceId(0);
+
     UnityVideoTrackSource::UnityVideoTrackSource(
         bool is_screencast, absl::optional<bool> needs_denoising, TaskQueueFactory* taskQueueFactory)
         : AdaptedVideoTrackSource(/*required_alignment=*/1)
+        , id_(++s_lastSourceId)
         , is_screencast_(is_screencast)
-        , frame_(nullptr)
+        , maxBufferCount_(GpuMemoryBufferPool::kDefaultMaxBufferCount)
+        , staleFrameLimitUs_(GpuMemoryBufferPool::kDefaultStaleFrameLimit.us())
+        , scaledLayerHistory_(std::make_shared<ScaledLayerHistory>())
+        , pendingFrame_(nullptr)
+        , overwrittenFrameCount_(0)
+        , contentDetector_(is_screencast ? std::make_unique<StaticContentDetector>() : nullptr)
+        , pendingUpdateRect_({ 0, 0, 0, 0 })
+        , lastAdaptationParams_({ false, 0, 0, 0, 0, 0, 0 })
+        , lastDeliveredUs_(0)
+        , staticFrameCount_(0)
     {
         taskQueue_ = std::make_unique<rtc::TaskQueue>(
             taskQueueFactory->CreateTaskQueue("VideoFrameScheduler", TaskQueueFactory::Priority::NORMAL));
@@ -27,7 +45,28 @@ namespace webrtc
         scheduler_->Start(std::bind(&UnityVideoTrackSource::CaptureNextFrame, this));
     }
 
-    UnityVideoTrackSource::~UnityVideoTrackSource() { scheduler_ = nullptr; }
+    UnityVideoTrackSource::~UnityVideoTrackSource()
+    {
+        scheduler_ = nullptr;
+        if (VideoFrame* frame = pendingFrame_.exchange(nullptr))
+            frame->Release();
+    }
+
+    void UnityVideoTrackSource::SetBufferPoolLimits(size_t maxBufferCount, TimeDelta staleFrameLimit)
+    {
+        maxBufferCount_ = maxBufferCount;
+        staleFrameLimitUs_ = staleFrameLimit.us();
+    }
+
+    size_t UnityVideoTrackSource::maxBufferCount() const { return maxBufferCount_; }
+
+    TimeDelta UnityVideoTrackSource::staleFrameLimit() const { return TimeDelta::Micros(staleFrameLimitUs_); }
+
+    uint64_t UnityVideoTrackSource::overwrittenFrameCount() const { return overwrittenFrameCount_; }
+
+    uint64_t UnityVideoTrackSource::staticFrameCount() const { return staticFrameCount_; }
+
+    VideoFrameSchedulerStats UnityVideoTrackSource::GetSchedulerStats() const { return scheduler_->GetStats(); }
 
     UnityVideoTrackSource::FrameAdaptationParams
     UnityVideoTrackSource::ComputeAdaptationParams(int width, int height, int64_t time_us)
@@ -56,30 +95,107 @@ namespace webrtc
 
     void UnityVideoTrackSource::CaptureNextFrame()
     {
-        const std::unique_lock<std::mutex> lock(mutex_);
-        if (!frame_)
+        VideoFrame* pending = pendingFrame_.exchange(nullptr, std::memory_order_acquire);
+        if (!pending)
             return;
+        // Take over the reference which the mailbox held.
+        rtc::scoped_refptr<VideoFrame> frame(pending);
+        pending->Release();
+
+        const int orig_width = frame->size().width();
+        const int orig_height = frame->size().height();
+        const int64_t now_us = CaptureClock::GetInstance().CurrentTime().us();
+        // The frame was stamped on the render thread. Remove the jitter of the
+        // render thread, and keep the timestamps monotonic and not in the future.
+        const int64_t capture_time_us = timestamp_aligner_.TranslateTimestamp(frame->timestamp().us(), now_us);
+        rtc::scoped_refptr<VideoFrameAdapter> frame_adapter(
+            new rtc::RefCountedObject<VideoFrameAdapter>(std::move(frame), scaledLayerHistory_));
 
-        const int orig_width = frame_->size().width();
-        const int orig_height = frame_->size().height();
-        const int64_t now_us = rtc::TimeMicros();
-        FrameAdaptationParams frame_adaptation_params = ComputeAdaptationParams(orig_width, orig_height, now_us);
+        // The static frame is skipped before the video adapter counts it.
+        if (contentDetector_ && !DetectUpdateRect(frame_adapter.get(), capture_time_us))
+            return;
+
+        FrameAdaptationParams frame_adaptation_params =
+            ComputeAdaptationParams(orig_width, orig_height, capture_time_us);
         if (frame_adaptation_params.should_drop_frame)
-        {
-            frame_ = nullptr;
             return;
-        }
 
-        const webrtc::TimeDelta timestamp = frame_->timestamp();
-        rtc::scoped_refptr<VideoFrameAdapter> frame_adapter(
-            new rtc::RefCountedObject<VideoFrameAdapter>(std::move(frame_)));
+        // Apply the crop and the scale which the video adapter requested.
+        rtc::scoped_refptr<::webrtc::VideoFrameBuffer> buffer = frame_adapter;
+        if (frame_adaptation_params.crop_x != 0 || frame_adaptation_params.crop_y != 0 ||
+            frame_adaptation_params.crop_width != orig_width || frame_adaptation_params.crop_height != orig_height ||
+            frame_adaptation_params.scale_to_width != orig_width ||
+            frame_adaptation_params.scale_to_height != orig_height)
+        {
+            buffer = frame_adapter->CropAndScale(
+                frame_adaptation_params.crop_x,
+                frame_adaptation_params.crop_y,
+                frame_adaptation_params.crop_width,
+                frame_adaptation_params.crop_height,
+                frame_adaptation_params.scale_to_width,
+                frame_adaptation_params.scale_to_height);
+        }
 
-        ::webrtc::VideoFrame::Builder builder = ::webrtc::VideoFrame::Builder()
-                                                    .set_video_frame_buffer(std::move(frame_adapter))
-                                                    .set_timestamp_us(timestamp.us());
+        // The NTP time is shared with the audio track sources for the lip-sync,
+        // and lets the receiver measure the latency from the capture.
+        ::webrtc::VideoFrame::Builder builder =
+            ::webrtc::VideoFrame::Builder()
+                .set_video_frame_buffer(std::move(buffer))
+                .set_timestamp_us(capture_time_us)
+                .set_ntp_time_ms(CaptureClock::GetInstance().ToNtpTimeMs(Timestamp::Micros(capture_time_us)));
+        if (contentDetector_)
+        {
+            const FrameAdaptationParams& last = lastAdaptationParams_;
+            const FrameAdaptationParams& params = frame_adaptation_params;
+            // The encoder needs the whole frame when the adaptation has changed.
+            if (params.crop_x != last.crop_x || params.crop_y != last.crop_y ||
+                params.crop_width != last.crop_width || params.crop_height != last.crop_height ||
+                params.scale_to_width != last.scale_to_width || params.scale_to_height != last.scale_to_height)
+            {
+                pendingUpdateRect_ = { 0, 0, orig_width, orig_height };
+            }
+            builder.set_update_rect(pendingUpdateRect_.ScaleWithFrame(
+                orig_width,
+                orig_height,
+                params.crop_x,
+                params.crop_y,
+                params.crop_width,
+                params.crop_height,
+                params.scale_to_width,
+                params.scale_to_height));
+            pendingUpdateRect_.MakeEmptyUpdate();
+            lastAdaptationParams_ = params;
+            lastDeliveredUs_ = capture_time_us;
+        }
         OnFrame(builder.build());
     }
 
+    bool UnityVideoTrackSource::DetectUpdateRect(VideoFrameAdapter* frame, int64_t time_us)
+    {
+        // The region is detected only when the CPU readable copy exists for the
+        // software encoder. The hardware encoders read the native handle, and
+        // reading back the texture only for the detection costs more than it saves.
+        // The copy which has not finished is not waited for either, because this
+        // runs on the sequence which the other sources share.
+        // The converted buffer is reused by the software encoder.
+        rtc::scoped_refptr<I420BufferInterface> i420 = frame->PeekI420();
+        if (!i420)
+        {
+            contentDetector_->Reset();
+            pendingUpdateRect_ = { 0, 0, frame->width(), frame->height() };
+            return true;
+        }
+
+        // Accumulated until the frame is delivered, because the video adapter may drop it.
+        pendingUpdateRect_.Union(contentDetector_->Detect(*i420));
+        if (!pendingUpdateRect_.IsEmpty())
+            return true;
+        if (time_us - lastDeliveredUs_ >= kMaxStaticFrameInterval.us())
+            return true;
+        staticFrameCount_++;
+        return false;
+    }
+
     void UnityVideoTrackSource::SendFeedback()
     {
         float maxFramerate = video_adapter()->GetMaxFramerate();
@@ -92,8 +208,17 @@ namespace webrtc
     {
         SendFeedback();
 
-        const std::unique_lock<std::mutex> lock(mutex_);
-        frame_ = frame;
+        // The mailbox owns the reference until the scheduler takes it.
+        frame->AddRef();
+        VideoFrame* previous = pendingFrame_.exchange(frame.get(), std::memory_order_acq_rel);
+        if (previous)
+        {
+            overwrittenFrameCount_++;
+            previous->Release();
+        }
+        // Notify after the frame is in the mailbox, otherwise the scheduler may
+        // consume the arrival without the frame.
+        scheduler_->OnFrameCaptured(frame.get());
     }
 
 } // end namespace webrtc
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <mutex>
+#include <atomic>
 
 #include <absl/types/optional.h>
 #include <api/media_stream_interface.h>
@@ -8,7 +8,10 @@
 #include <media/base/adapted_video_track_source.h>
 #include <rtc_base/task_queue.h>
 
+#include "StaticContentDetector.h"
 #include "VideoFrame.h"
+#include "VideoFrameAdapter.h"
+#include "VideoFrameScheduler.h"
 
 namespace unity
 {
@@ -21,7 +24,6 @@ namespace webrtc
     // the webrtc video pipeline, each received a media::VideoFrame is converted to
     // a webrtc::VideoFrame, taking any adaptation requested by downstream classes
     // into account.
-    class VideoFrameScheduler;
     class UnityVideoTrackSource : public rtc::AdaptedVideoTrackSource
     {
     public:
@@ -45,8 +47,24 @@ namespace webrtc
         bool remote() const override;
         bool is_screencast() const override;
         absl::optional<bool> needs_denoising() const override;
+        // Called on the render thread. Never blocks; the frame which has not
+        // been consumed yet is replaced with |frame|.
         void OnFrameCaptured(rtc::scoped_refptr<VideoFrame> frame);
 
+        // The number of frames which were replaced before the scheduler consumed them.
+        uint64_t overwrittenFrameCount() const;
+        // The number of screencast frames which were not delivered because nothing changed.
+        uint64_t staticFrameCount() const;
+        VideoFrameSchedulerStats GetSchedulerStats() const;
+
+        // Unique in the process, unlike the address which may be reused by the next source.
+        uint64_t id() const { return id_; }
+
+        // Limits of the buffer pool which is used for this source on the render thread.
+        void SetBufferPoolLimits(size_t maxBufferCount, TimeDelta staleFrameLimit);
+        size_t maxBufferCount() const;
+        TimeDelta staleFrameLimit() const;
+
         using VideoTrackSourceInterface::AddOrUpdateSink;
         using VideoTrackSourceInterface::RemoveSink;
 
@@ -57,6 +75,8 @@ namespace webrtc
         void CaptureNextFrame();
         void SendFeedback();
         FrameAdaptationParams ComputeAdaptationParams(int width, int height, int64_t time_us);
+        // Returns false if the frame is static and should not be delivered.
+        bool DetectUpdateRect(VideoFrameAdapter* frame, int64_t time_us);
 
         // Delivers |frame| to base class method
         // rtc::AdaptedVideoTrackSource::OnFrame(). If the cropping (given via
@@ -70,16 +90,31 @@ namespace webrtc
         // todo::(kazuki) change compiler vc to clang
         // media::VideoFramePool scaled_frame_pool_;
 
-        // State for the timestamp translation.
+        // State for the timestamp translation. Used on the task queue of the scheduler.
         rtc::TimestampAligner timestamp_aligner_;
 
+        const uint64_t id_;
         const bool is_screencast_;
         const absl::optional<bool> needs_denoising_;
-        std::mutex mutex_;
+        std::atomic<size_t> maxBufferCount_;
+        std::atomic<int64_t> staleFrameLimitUs_;
 
         std::unique_ptr<rtc::TaskQueue> taskQueue_;
         std::unique_ptr<VideoFrameScheduler> scheduler_;
-        rtc::scoped_refptr<unity::webrtc::VideoFrame> frame_;
+        const std::shared_ptr<ScaledLayerHistory> scaledLayerHistory_;
+
+        // Single-slot mailbox from the render thread to the scheduler.
+        // Holds a reference of the latest frame which has not been consumed.
+        std::atomic<unity::webrtc::VideoFrame*> pendingFrame_;
+        std::atomic<uint64_t> overwrittenFrameCount_;
+
+        // Used on the task queue of the scheduler only for the screencast.
+        std::unique_ptr<StaticContentDetector> contentDetector_;
+        // The region which changed since the last delivered frame.
+        ::webrtc::VideoFrame::UpdateRect pendingUpdateRect_;
+        FrameAdaptationParams lastAdaptationParams_;
+        int64_t lastDeliveredUs_;
+        std::atomic<uint64_t> staticFrameCount_;
     };
 
 } // end namespace webrtc
@@ -1,6 +1,10 @@
 #include "pch.h"
 
+#include <algorithm>
+
+#include <api/video/i420_buffer.h>
 #include <api/video/video_frame.h>
+#include <common_video/include/video_frame_buffer.h>
 
 #include "VideoFrameAdapter.h"
 
@@ -8,6 +12,8 @@ namespace unity
 {
 namespace webrtc
 {
+    constexpr uint64_t ScaledLayerHistory::kMaxUnusedFrames;
+
     template<typename T>
     bool Contains(rtc::ArrayView<T> arr, T value)
     {
@@ -19,6 +25,96 @@ namespace webrtc
         return false;
     }
 
+    // Returns the view of the region of |buffer| without copying the pixels.
+    // The chroma planes are cropped from the even position like I420Buffer::CropAndScaleFrom.
+    static rtc::scoped_refptr<I420BufferInterface>
+    CropI420Buffer(rtc::scoped_refptr<I420BufferInterface> buffer, const ScaledLayerKey& key)
+    {
+        if (key.offsetX == 0 && key.offsetY == 0 && key.cropWidth == buffer->width() &&
+            key.cropHeight == buffer->height())
+            return buffer;
+
+        // The chroma planes are subsampled, so the region is aligned to the
+        // even pixels like I420Buffer::CropAndScaleFrom, otherwise the chroma
+        // is shifted half a pixel from the luma.
+        const int uvOffsetX = key.offsetX / 2;
+        const int uvOffsetY = key.offsetY / 2;
+        const int offsetX = uvOffsetX * 2;
+        const int offsetY = uvOffsetY * 2;
+        const int cropWidth = key.cropWidth > 1 ? key.cropWidth & ~1 : key.cropWidth;
+        const int cropHeight = key.cropHeight > 1 ? key.cropHeight & ~1 : key.cropHeight;
+        const uint8_t* dataY = buffer->DataY() + buffer->StrideY() * offsetY + offsetX;
+        const uint8_t* dataU = buffer->DataU() + buffer->StrideU() * uvOffsetY + uvOffsetX;
+        const uint8_t* dataV = buffer->DataV() + buffer->StrideV() * uvOffsetY + uvOffsetX;
+        return WrapI420Buffer(
+            cropWidth,
+            cropHeight,
+            dataY,
+            buffer->StrideY(),
+            dataU,
+            buffer->StrideU(),
+            dataV,
+            buffer->StrideV(),
+            [buffer]() {});
+    }
+
+    void ScaledLayerHistory::NextFrame()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        frame_++;
+        size_t count = 0;
+        for (size_t i = 0; i < count_; i++)
+        {
+            if (frame_ - layers_[i].lastRequestedFrame <= kMaxUnusedFrames)
+                layers_[count++] = layers_[i];
+        }
+        count_ = count;
+    }
+
+    void ScaledLayerHistory::Add(const Size& frameSize, const ScaledLayerKey& layer)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (frameSize_ != frameSize)
+        {
+            frameSize_ = frameSize;
+            count_ = 0;
+        }
+        for (size_t i = 0; i < count_; i++)
+        {
+            if (layers_[i].key == layer)
+            {
+                layers_[i].lastRequestedFrame = frame_;
+                return;
+            }
+        }
+        Entry* entry = nullptr;
+        if (count_ < layers_.size())
+        {
+            entry = &layers_[count_++];
+        }
+        else
+        {
+            entry = &*std::min_element(
+                layers_.begin(),
+                layers_.end(),
+                [](const Entry& a, const Entry& b) { return a.lastRequestedFrame < b.lastRequestedFrame; });
+        }
+        entry->key = layer;
+        entry->lastRequestedFrame = frame_;
+    }
+
+    std::vector<ScaledLayerKey> ScaledLayerHistory::Get(const Size& frameSize) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (frameSize_ != frameSize)
+            return {};
+        std::vector<ScaledLayerKey> layers;
+        layers.reserve(count_);
+        for (size_t i = 0; i < count_; i++)
+            layers.push_back(layers_[i].key);
+        return layers;
+    }
+
     ::webrtc::VideoFrame VideoFrameAdapter::CreateVideoFrame(rtc::scoped_refptr<VideoFrame> frame)
     {
         rtc::scoped_refptr<VideoFrameAdapter> adapter(new rtc::RefCountedObject<VideoFrameAdapter>(std::move(frame)));
@@ -26,10 +122,10 @@ namespace webrtc
         return ::webrtc::VideoFrame::Builder().set_video_frame_buffer(adapter).build();
     }
 
-    VideoFrameAdapter::ScaledBuffer::ScaledBuffer(rtc::scoped_refptr<VideoFrameAdapter> parent, int width, int height)
+    VideoFrameAdapter::ScaledBuffer::ScaledBuffer(
+        rtc::scoped_refptr<VideoFrameAdapter> parent, const ScaledLayerKey& key)
         : parent_(parent)
-        , width_(width)
-        , height_(height)
+        , key_(key)
     {
     }
 
@@ -39,33 +135,45 @@ namespace webrtc
 
     rtc::scoped_refptr<webrtc::I420BufferInterface> VideoFrameAdapter::ScaledBuffer::ToI420()
     {
-        return parent_->GetOrCreateFrameBufferForSize(Size(width_, height_))->ToI420();
+        auto buffer = parent_->GetOrCreateFrameBuffer(key_);
+        return buffer ? buffer->ToI420() : nullptr;
     }
 
     const I420BufferInterface* VideoFrameAdapter::ScaledBuffer::GetI420() const
     {
-        return parent_->GetOrCreateFrameBufferForSize(Size(width_, height_))->GetI420();
+        auto buffer = parent_->GetOrCreateFrameBuffer(key_);
+        return buffer ? buffer->GetI420() : nullptr;
     }
 
     rtc::scoped_refptr<VideoFrameBuffer>
     VideoFrameAdapter::ScaledBuffer::GetMappedFrameBuffer(rtc::ArrayView<VideoFrameBuffer::Type> types)
     {
-        auto buffer = parent_->GetOrCreateFrameBufferForSize(Size(width_, height_));
-        return Contains(types, buffer->type()) ? buffer : nullptr;
+        auto buffer = parent_->GetOrCreateFrameBuffer(key_);
+        return buffer && Contains(types, buffer->type()) ? buffer : nullptr;
     }
 
     rtc::scoped_refptr<VideoFrameBuffer> VideoFrameAdapter::ScaledBuffer::CropAndScale(
         int offset_x, int offset_y, int crop_width, int crop_height, int scaled_width, int scaled_height)
     {
-        RTC_DCHECK_NOTREACHED();
-
-        return nullptr;
+        // Map the region of this buffer to the region of the original frame.
+        const int64_t width = key_.size.width();
+        const int64_t height = key_.size.height();
+        const int x = key_.offsetX + static_cast<int>(offset_x * key_.cropWidth / width);
+        const int y = key_.offsetY + static_cast<int>(offset_y * key_.cropHeight / height);
+        const int w = static_cast<int>(crop_width * key_.cropWidth / width);
+        const int h = static_cast<int>(crop_height * key_.cropHeight / height);
+        return parent_->CropAndScale(x, y, w, h, scaled_width, scaled_height);
     }
 
-    VideoFrameAdapter::VideoFrameAdapter(rtc::scoped_refptr<VideoFrame> frame)
-        : frame_(std::move(frame))
+    VideoFrameAdapter::VideoFrameAdapter(
+        rtc::scoped_refptr<VideoFrame> frame, std::shared_ptr<ScaledLayerHistory> history)
+        : scaledLayerCount_(0)
+        , history_(std::move(history))
+        , frame_(std::move(frame))
         , size_(frame_->size())
     {
+        if (history_)
+            history_->NextFrame();
     }
 
     VideoFrameBuffer::Type VideoFrameAdapter::type() const
@@ -90,28 +198,149 @@ namespace webrtc
         return ConvertToVideoFrameBuffer(frame_)->ToI420();
     }
 
+    rtc::scoped_refptr<I420BufferInterface> VideoFrameAdapter::PeekI420() const
+    {
+        {
+            std::unique_lock<std::mutex> guard(convertLock_);
+            if (i420Buffer_)
+                return i420Buffer_;
+        }
+        RTC_DCHECK(frame_->HasGpuMemoryBuffer());
+        return frame_->GetGpuMemoryBuffer()->PeekI420();
+    }
+
+    rtc::scoped_refptr<VideoFrameBuffer>
+    VideoFrameAdapter::GetMappedFrameBuffer(rtc::ArrayView<VideoFrameBuffer::Type> types)
+    {
+        {
+            // Prefer the buffer which has already been converted.
+            std::unique_lock<std::mutex> guard(convertLock_);
+            if (i420Buffer_ && Contains(types, VideoFrameBuffer::Type::kI420))
+                return i420Buffer_;
+            if (nv12Buffer_ && Contains(types, VideoFrameBuffer::Type::kNV12))
+                return nv12Buffer_;
+        }
+        if (Contains(types, VideoFrameBuffer::Type::kNV12))
+            return ConvertToNV12Buffer(frame_);
+        if (Contains(types, VideoFrameBuffer::Type::kI420))
+            return ConvertToVideoFrameBuffer(frame_);
+        return nullptr;
+    }
+
     rtc::scoped_refptr<VideoFrameBuffer> VideoFrameAdapter::CropAndScale(
         int offset_x, int offset_y, int crop_width, int crop_height, int scaled_width, int scaled_height)
     {
-        return rtc::make_ref_counted<ScaledBuffer>(
-            rtc::scoped_refptr<VideoFrameAdapter>(this), scaled_width, scaled_height);
+        RTC_DCHECK_GE(offset_x, 0);
+        RTC_DCHECK_GE(offset_y, 0);
+        RTC_DCHECK_LE(offset_x + crop_width, width());
+        RTC_DCHECK_LE(offset_y + crop_height, height());
+
+        ScaledLayerKey key;
+        key.offsetX = offset_x;
+        key.offsetY = offset_y;
+        key.cropWidth = crop_width;
+        key.cropHeight = crop_height;
+        key.size = Size(scaled_width, scaled_height);
+        {
+            // Register the layer to build it with the others.
+            std::unique_lock<std::mutex> guard(scaleLock_);
+            FindOrAddLayer(key);
+        }
+        if (history_)
+            history_->Add(size_, key);
+
+        return rtc::make_ref_counted<ScaledBuffer>(rtc::scoped_refptr<VideoFrameAdapter>(this), key);
     }
 
-    rtc::scoped_refptr<VideoFrameBuffer> VideoFrameAdapter::GetOrCreateFrameBufferForSize(const Size& size)
+    VideoFrameAdapter::ScaledLayer* VideoFrameAdapter::FindOrAddLayer(const ScaledLayerKey& key)
     {
-        std::unique_lock<std::mutex> guard(scaleLock_);
+        for (size_t i = 0; i < scaledLayerCount_; i++)
+        {
+            if (scaledLayers_[i].key == key)
+                return &scaledLayers_[i];
+        }
+        if (scaledLayerCount_ == scaledLayers_.size())
+            return nullptr;
+        ScaledLayer* layer = &scaledLayers_[scaledLayerCount_++];
+        layer->key = key;
+        return layer;
+    }
+
+    rtc::scoped_refptr<VideoFrameBuffer> VideoFrameAdapter::CreateScaledBuffer(
+        const ScaledLayerKey& key, rtc::scoped_refptr<I420BufferInterface> source) const
+    {
+        rtc::scoped_refptr<I420BufferInterface> cropped = CropI420Buffer(source, key);
+        if (cropped->width() == key.size.width() && cropped->height() == key.size.height())
+            return cropped;
+        rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(key.size.width(), key.size.height());
+        buffer->ScaleFrom(*cropped);
+        return buffer;
+    }
 
-        for (auto scaledI420buffer : scaledI40Buffers_)
+    void VideoFrameAdapter::BuildScaledLayers()
+    {
+        if (history_)
+        {
+            for (const ScaledLayerKey& key : history_->Get(size_))
+                FindOrAddLayer(key);
+        }
+
+        // From the largest layer to the smallest one.
+        std::array<ScaledLayer*, kMaxScaledLayers> layers;
+        for (size_t i = 0; i < scaledLayerCount_; i++)
+            layers[i] = &scaledLayers_[i];
+        std::sort(
+            layers.begin(),
+            layers.begin() + scaledLayerCount_,
+            [](const ScaledLayer* a, const ScaledLayer* b)
+            {
+                return a->key.size.width() * a->key.size.height() > b->key.size.width() * b->key.size.height();
+            });
+
+        rtc::scoped_refptr<I420BufferInterface> source = ConvertToVideoFrameBuffer(frame_);
+        if (!source)
+            return;
+        for (size_t i = 0; i < scaledLayerCount_; i++)
         {
-            Size bufferSize(scaledI420buffer->width(), scaledI420buffer->height());
-            if (size == bufferSize)
+            ScaledLayer* layer = layers[i];
+            if (layer->buffer)
+                continue;
+
+            // The smallest layer which is larger than this layer has already been built.
+            const Size& size = layer->key.size;
+            const VideoFrameBuffer* parent = nullptr;
+            for (size_t j = 0; j < i; j++)
             {
-                return scaledI420buffer;
+                const VideoFrameBuffer* candidate = layers[j]->buffer.get();
+                if (candidate && layers[j]->key.IsSameCrop(layer->key) && candidate->width() >= size.width() &&
+                    candidate->height() >= size.height())
+                    parent = candidate;
             }
+            if (!parent)
+            {
+                layer->buffer = CreateScaledBuffer(layer->key, source);
+                continue;
+            }
+            rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(size.width(), size.height());
+            buffer->ScaleFrom(*parent->GetI420());
+            layer->buffer = buffer;
         }
-        auto buffer = VideoFrameBuffer::CropAndScale(0, 0, width(), height(), size.width(), size.height());
-        scaledI40Buffers_.push_back(buffer);
-        return buffer;
+    }
+
+    rtc::scoped_refptr<VideoFrameBuffer> VideoFrameAdapter::GetOrCreateFrameBuffer(const ScaledLayerKey& key)
+    {
+        std::unique_lock<std::mutex> guard(scaleLock_);
+
+        ScaledLayer* layer = FindOrAddLayer(key);
+        if (!layer)
+        {
+            // The slot table is full.
+            rtc::scoped_refptr<I420BufferInterface> source = ConvertToVideoFrameBuffer(frame_);
+            return source ? CreateScaledBuffer(key, source) : nullptr;
+        }
+        if (!layer->buffer)
+            BuildScaledLayers();
+        return layer->buffer;
     }
 
     rtc::scoped_refptr<I420BufferInterface>
@@ -121,6 +350,13 @@ namespace webrtc
         if (i420Buffer_)
             return i420Buffer_;
 
+        // Converting from NV12 on CPU is cheaper than reading back the texture again.
+        if (nv12Buffer_)
+        {
+            i420Buffer_ = nv12Buffer_->ToI420();
+            return i420Buffer_;
+        }
+
         RTC_DCHECK(video_frame);
         RTC_DCHECK(video_frame->HasGpuMemoryBuffer());
 
@@ -129,5 +365,20 @@ namespace webrtc
         return i420Buffer_;
     }
 
+    rtc::scoped_refptr<NV12BufferInterface>
+    VideoFrameAdapter::ConvertToNV12Buffer(rtc::scoped_refptr<VideoFrame> video_frame) const
+    {
+        std::unique_lock<std::mutex> guard(convertLock_);
+        if (nv12Buffer_)
+            return nv12Buffer_;
+
+        RTC_DCHECK(video_frame);
+        RTC_DCHECK(video_frame->HasGpuMemoryBuffer());
+
+        auto gmb = video_frame->GetGpuMemoryBuffer();
+        nv12Buffer_ = gmb->ToNV12();
+        return nv12Buffer_;
+    }
+
 }
 }
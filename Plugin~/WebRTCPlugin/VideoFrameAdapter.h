@@ -1,7 +1,10 @@
 #pragma once
 
+#include <array>
+#include <memory>
+#include <mutex>
+
 #include <api/video/video_frame.h>
-#include <vector>
 
 #include "VideoFrame.h"
 
@@ -21,18 +24,69 @@ namespace webrtc
         ~ScalableBufferInterface() override { }
     };
 
+    // The number of the scaled layers which one frame caches.
+    constexpr size_t kMaxScaledLayers = 8;
+
+    // The region of the original frame which the layer is cropped from, and the scaled size.
+    struct ScaledLayerKey
+    {
+        int offsetX = 0;
+        int offsetY = 0;
+        int cropWidth = 0;
+        int cropHeight = 0;
+        Size size;
+
+        bool IsSameCrop(const ScaledLayerKey& other) const
+        {
+            return offsetX == other.offsetX && offsetY == other.offsetY && cropWidth == other.cropWidth &&
+                cropHeight == other.cropHeight;
+        }
+        bool operator==(const ScaledLayerKey& other) const { return IsSameCrop(other) && size == other.size; }
+    };
+
+    // Remembers the layers which the encoders requested for the previous
+    // frames, so that all layers of the next frame are built at once.
+    // The layers which are no longer requested, e.g. after the adaptation
+    // changed the resolution, are forgotten.
+    // Shared by the frames of the same source.
+    class ScaledLayerHistory
+    {
+    public:
+        // The layer which has not been requested for this number of the frames is removed.
+        static constexpr uint64_t kMaxUnusedFrames = 30;
+
+        // Called for each frame of the source.
+        void NextFrame();
+        // Replaces the least recently requested layer when the history is full.
+        void Add(const Size& frameSize, const ScaledLayerKey& layer);
+        std::vector<ScaledLayerKey> Get(const Size& frameSize) const;
+
+    private:
+        struct Entry
+        {
+            ScaledLayerKey key;
+            uint64_t lastRequestedFrame = 0;
+        };
+
+        mutable std::mutex mutex_;
+        Size frameSize_;
+        std::array<Entry, kMaxScaledLayers> layers_;
+        size_t count_ = 0;
+        uint64_t frame_ = 0;
+    };
+
     class VideoFrameAdapter : public ScalableBufferInterface
     {
     public:
         class ScaledBuffer : public ScalableBufferInterface
         {
         public:
-            ScaledBuffer(rtc::scoped_refptr<VideoFrameAdapter> parent, int width, int height);
+            ScaledBuffer(rtc::scoped_refptr<VideoFrameAdapter> parent, const ScaledLayerKey& key);
             ~ScaledBuffer() override;
 
             VideoFrameBuffer::Type type() const override;
-            int width() const override { return width_; }
-            int height() const override { return height_; }
+            int width() const override { return key_.size.width(); }
+            int height() const override { return key_.size.height(); }
             bool scaled() const final { return true; }
 
             rtc::scoped_refptr<webrtc::I420BufferInterface> ToI420() override;
@@ -49,11 +103,11 @@ namespace webrtc
 
         private:
             const rtc::scoped_refptr<VideoFrameAdapter> parent_;
-            const int width_;
-            const int height_;
+            const ScaledLayerKey key_;
         };
 
-        explicit VideoFrameAdapter(rtc::scoped_refptr<VideoFrame> frame);
+        explicit VideoFrameAdapter(
+            rtc::scoped_refptr<VideoFrame> frame, std::shared_ptr<ScaledLayerHistory> history = nullptr);
 
         static ::webrtc::VideoFrame CreateVideoFrame(rtc::scoped_refptr<VideoFrame> frame);
 
@@ -66,6 +120,12 @@ namespace webrtc
 
         const I420BufferInterface* GetI420() const override;
         rtc::scoped_refptr<I420BufferInterface> ToI420() override;
+        // Returns the I420 buffer only if it is available without reading back the texture.
+        // Not counted as the read of the encoder.
+        rtc::scoped_refptr<I420BufferInterface> PeekI420() const;
+        // Returns NV12 if the consumer accepts it, which the devices convert to without the extra plane shuffle.
+        rtc::scoped_refptr<webrtc::VideoFrameBuffer>
+        GetMappedFrameBuffer(rtc::ArrayView<webrtc::VideoFrameBuffer::Type> types) override;
         rtc::scoped_refptr<webrtc::VideoFrameBuffer> CropAndScale(
             int offset_x, int offset_y, int crop_width, int crop_height, int scaled_width, int scaled_height) override;
 
@@ -73,13 +133,30 @@ namespace webrtc
         ~VideoFrameAdapter() override { }
 
     private:
-        rtc::scoped_refptr<webrtc::VideoFrameBuffer> GetOrCreateFrameBufferForSize(const Size& size);
+        struct ScaledLayer
+        {
+            ScaledLayerKey key;
+            rtc::scoped_refptr<VideoFrameBuffer> buffer;
+        };
+
+        rtc::scoped_refptr<webrtc::VideoFrameBuffer> GetOrCreateFrameBuffer(const ScaledLayerKey& key);
+        // Returns the slot of the layer, or nullptr if the slot table is full.
+        ScaledLayer* FindOrAddLayer(const ScaledLayerKey& key);
+        // Builds all requested layers in one pass. Each layer is scaled from the
+        // smallest layer which is larger than it and has the same crop region.
+        void BuildScaledLayers();
+        rtc::scoped_refptr<VideoFrameBuffer>
+        CreateScaledBuffer(const ScaledLayerKey& key, rtc::scoped_refptr<I420BufferInterface> source) const;
         rtc::scoped_refptr<I420BufferInterface>
         ConvertToVideoFrameBuffer(rtc::scoped_refptr<VideoFrame> video_frame) const;
+        rtc::scoped_refptr<NV12BufferInterface> ConvertToNV12Buffer(rtc::scoped_refptr<VideoFrame> video_frame) const;
         // todo(kazuki):
         // Need this buffer because the type() method returns kI420.
         mutable rtc::scoped_refptr<I420BufferInterface> i420Buffer_;
-        std::vector<rtc::scoped_refptr<VideoFrameBuffer>> scaledI40Buffers_;
+        mutable rtc::scoped_refptr<NV12BufferInterface> nv12Buffer_;
+        std::array<ScaledLayer, kMaxScaledLayers> scaledLayers_;
+        size_t scaledLayerCount_;
+        const std::shared_ptr<ScaledLayerHistory> history_;
         const rtc::scoped_refptr<VideoFrame> frame_;
         const Size size_;
         mutable std::mutex scaleLock_;
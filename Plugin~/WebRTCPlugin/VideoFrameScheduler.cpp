@@ -1,5 +1,6 @@
 #include "pch.h"
 
+#include <cstdlib>
 #include <functional>
 #include <rtc_base/event.h>
 
@@ -10,12 +11,37 @@ namespace unity
 namespace webrtc
 {
     constexpr TimeDelta kTimeout = TimeDelta::Millis(1000);
+    // The interval longer than this is not used for the prediction, e.g. the application was paused.
+    constexpr TimeDelta kMaxArrivalInterval = TimeDelta::Seconds(1);
+    // The capture waits this much after the predicted arrival at least.
+    constexpr TimeDelta kMinArrivalMargin = TimeDelta::Millis(1);
+    // The late frame is retried often only for this many intervals, then the
+    // source is considered stopped and the tick falls back to the max framerate.
+    constexpr int kMaxLateArrivals = 4;
+    // Weights of the smoothing as the shift of the denominator.
+    constexpr int kIntervalSmoothingShift = 3;
+    constexpr int kJitterSmoothingShift = 4;
+
+    static int64_t Smooth(int64_t average, int64_t value, int shift)
+    {
+        return average + (value - average) / (int64_t(1) << shift);
+    }
 
     VideoFrameScheduler::VideoFrameScheduler(TaskQueueBase* queue, Clock* clock)
         : maxFramerate_(30)
         , queue_(queue)
         , lastCaptureStartedTime_(Timestamp::Zero())
         , clock_(clock)
+        , arrivedFrames_(0)
+        , arrivalSequence_(0)
+        , lastArrivalUs_(0)
+        , arrivalIntervalUs_(0)
+        , arrivalJitterUs_(0)
+        , lastCapturedFrame_(0)
+        , capturedFrames_(0)
+        , duplicateTicks_(0)
+        , missedFrames_(0)
+        , captureDelayUs_(0)
     {
     }
 
@@ -51,11 +77,75 @@ namespace webrtc
         }
     }
 
-    void VideoFrameScheduler::OnFrameCaptured(const VideoFrame* frame) { }
+    void VideoFrameScheduler::OnFrameCaptured(const VideoFrame* frame)
+    {
+        if (!frame)
+            return;
+
+        // Only the render thread writes the fields, so they are read without the sequence.
+        const int64_t nowUs = clock_->CurrentTime().us();
+        int64_t averageUs = arrivalIntervalUs_.load(std::memory_order_relaxed);
+        int64_t jitterUs = arrivalJitterUs_.load(std::memory_order_relaxed);
+        if (arrivedFrames_ > 0)
+        {
+            const int64_t intervalUs = nowUs - lastArrivalUs_.load(std::memory_order_relaxed);
+            if (intervalUs > kMaxArrivalInterval.us())
+            {
+                averageUs = 0;
+            }
+            else if (averageUs == 0)
+            {
+                averageUs = intervalUs;
+            }
+            else
+            {
+                // Like the interarrival jitter of RFC 3550.
+                const int64_t deviationUs = std::abs(intervalUs - averageUs);
+                jitterUs = Smooth(jitterUs, deviationUs, kJitterSmoothingShift);
+                averageUs = Smooth(averageUs, intervalUs, kIntervalSmoothingShift);
+            }
+        }
+
+        arrivalSequence_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        lastArrivalUs_.store(nowUs, std::memory_order_relaxed);
+        arrivalIntervalUs_.store(averageUs, std::memory_order_relaxed);
+        arrivalJitterUs_.store(jitterUs, std::memory_order_relaxed);
+        arrivalSequence_.fetch_add(1, std::memory_order_release);
+
+        // Published last, so that the arrival time is visible to the task queue.
+        arrivedFrames_++;
+    }
 
     void VideoFrameScheduler::SetMaxFramerateFps(int maxFramerate) { maxFramerate_ = maxFramerate; }
 
-    absl::optional<TimeDelta> VideoFrameScheduler::ScheduleNextFrame()
+    VideoFrameSchedulerStats VideoFrameScheduler::GetStats() const
+    {
+        VideoFrameSchedulerStats stats;
+        stats.capturedFrames = capturedFrames_;
+        stats.duplicateTicks = duplicateTicks_;
+        stats.missedFrames = missedFrames_;
+        stats.arrivalJitterUs = arrivalJitterUs_;
+        stats.captureDelayUs = captureDelayUs_;
+        return stats;
+    }
+
+    VideoFrameScheduler::ArrivalEstimate VideoFrameScheduler::LoadArrivalEstimate() const
+    {
+        ArrivalEstimate estimate;
+        uint32_t sequence;
+        do
+        {
+            sequence = arrivalSequence_.load(std::memory_order_acquire);
+            estimate.lastArrivalUs = lastArrivalUs_.load(std::memory_order_relaxed);
+            estimate.intervalUs = arrivalIntervalUs_.load(std::memory_order_relaxed);
+            estimate.jitterUs = arrivalJitterUs_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((sequence & 1) != 0 || sequence != arrivalSequence_.load(std::memory_order_relaxed));
+        return estimate;
+    }
+
+    absl::optional<TimeDelta> VideoFrameScheduler::ScheduleNextFrame(bool captured)
     {
         if (paused_)
         {
@@ -74,14 +164,57 @@ namespace webrtc
 
         Timestamp now = clock_->CurrentTime();
         TimeDelta interval = std::max(TimeDelta::Seconds(1) / maxFramerate_, TimeDelta::Millis(1));
-        Timestamp target_capture_time = std::max(lastCaptureStartedTime_ + interval, now);
+        Timestamp target_capture_time = lastCaptureStartedTime_ + interval;
+
+        const ArrivalEstimate estimate = LoadArrivalEstimate();
+        const TimeDelta arrivalInterval = TimeDelta::Micros(estimate.intervalUs);
+        const Timestamp lastArrival = Timestamp::Micros(estimate.lastArrivalUs);
+        if (arrivalInterval > TimeDelta::Zero())
+        {
+            if (!captured)
+            {
+                // The source has stopped sending the frames.
+                if (now - lastArrival > std::min(arrivalInterval * kMaxLateArrivals, kMaxArrivalInterval))
+                    return interval;
+                // The frame is late. Retry before the next frame is expected.
+                return std::min(std::max(arrivalInterval / 4, TimeDelta::Millis(1)), interval);
+            }
+            // Capture just after the next frame arrives, so that the frame does
+            // not wait in the source until the next tick.
+            const TimeDelta margin = std::min(
+                std::max(TimeDelta::Micros(estimate.jitterUs) * 2, kMinArrivalMargin), arrivalInterval / 2);
+            const Timestamp predictedArrival = lastArrival + arrivalInterval;
+            target_capture_time = std::max(target_capture_time, predictedArrival + margin);
+        }
+        else if (!captured)
+        {
+            // No estimate of the arrival yet. The last capture may be long ago,
+            // so retry after the interval instead of posting the task again at once.
+            return interval;
+        }
+        target_capture_time = std::max(target_capture_time, now);
         return target_capture_time - now;
     }
 
-    void VideoFrameScheduler::CaptureNextFrame()
+    bool VideoFrameScheduler::CaptureNextFrame()
     {
+        const uint64_t arrivedFrames = arrivedFrames_;
+        if (arrivedFrames == lastCapturedFrame_)
+        {
+            // No fresh frame. Encoding the same frame again only costs.
+            if (arrivedFrames > 0)
+                duplicateTicks_++;
+            return false;
+        }
+        missedFrames_ += arrivedFrames - lastCapturedFrame_ - 1;
+        lastCapturedFrame_ = arrivedFrames;
+        capturedFrames_++;
+
         lastCaptureStartedTime_ = clock_->CurrentTime();
+        const int64_t delayUs = lastCaptureStartedTime_.us() - lastArrivalUs_.load(std::memory_order_relaxed);
+        captureDelayUs_ = capturedFrames_ == 1 ? delayUs : Smooth(captureDelayUs_, delayUs, kJitterSmoothingShift);
         callback_();
+        return true;
     }
 
     void VideoFrameScheduler::StartRepeatingTask()
@@ -89,12 +222,12 @@ namespace webrtc
         RTC_DCHECK(!paused_);
         RTC_DCHECK(!task_.Running());
 
-        auto firstDelay = ScheduleNextFrame();
+        auto firstDelay = ScheduleNextFrame(true);
         RTC_DCHECK(firstDelay);
 
         task_ = RepeatingTaskHandle::DelayedStart(queue_, firstDelay.value(), [this]() {
-            CaptureNextFrame();
-            auto delay = ScheduleNextFrame();
+            bool captured = CaptureNextFrame();
+            auto delay = ScheduleNextFrame(captured);
             if (delay.has_value())
                 return delay.value();
             return TimeDelta::PlusInfinity();
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include <rtc_base/task_utils/repeating_task.h>
 
 #include "VideoFrame.h"
@@ -8,6 +10,24 @@ namespace unity
 {
 namespace webrtc
 {
+    // Exposed to the managed code.
+    struct VideoFrameSchedulerStats
+    {
+        // The number of ticks which captured the fresh frame.
+        uint64_t capturedFrames;
+        // The number of ticks which were skipped because no fresh frame had arrived.
+        uint64_t duplicateTicks;
+        // The number of frames which arrived but were replaced before being captured.
+        uint64_t missedFrames;
+        // The smoothed variation of the interval between the arriving frames.
+        int64_t arrivalJitterUs;
+        // The smoothed delay from the arrival of the frame to the capture.
+        int64_t captureDelayUs;
+    };
+
+    // Schedules the capture of the frames from the render thread. The capture is
+    // aligned to the predicted arrival of the next frame, and the tick is skipped
+    // when no fresh frame has arrived since the last capture.
     class VideoFrameScheduler
     {
     public:
@@ -24,17 +44,31 @@ namespace webrtc
         // Pause and resumes the scheduler.
         virtual void Pause(bool pause);
 
-        // Called after |frame| has been captured. |frame| may be set to nullptr
-        // if the capture request failed.
+        // Called on the render thread after |frame| has been captured. |frame|
+        // may be set to nullptr if the capture request failed.
         virtual void OnFrameCaptured(const VideoFrame* frame);
 
         // Called when WebRTC requests the VideoTrackSource to provide frames
         // at a maximum framerate.
         virtual void SetMaxFramerateFps(int maxFramerate);
 
+        // Thread-safe.
+        VideoFrameSchedulerStats GetStats() const;
+
     private:
-        absl::optional<TimeDelta> ScheduleNextFrame();
-        void CaptureNextFrame();
+        struct ArrivalEstimate
+        {
+            int64_t lastArrivalUs;
+            // Smoothed interval between the arriving frames. Zero when unknown.
+            int64_t intervalUs;
+            int64_t jitterUs;
+        };
+        // Reads the fields of the estimate which the render thread has written together.
+        ArrivalEstimate LoadArrivalEstimate() const;
+
+        absl::optional<TimeDelta> ScheduleNextFrame(bool captured);
+        // Returns false if the tick is skipped.
+        bool CaptureNextFrame();
         void StartRepeatingTask();
         void StopTask();
 
@@ -45,6 +79,21 @@ namespace webrtc
         TaskQueueBase* queue_;
         Timestamp lastCaptureStartedTime_;
         Clock* clock_;
+
+        // Written on the render thread. The fields of the estimate are published
+        // together through |arrivalSequence_|, which is odd while they are written.
+        std::atomic<uint64_t> arrivedFrames_;
+        std::atomic<uint32_t> arrivalSequence_;
+        std::atomic<int64_t> lastArrivalUs_;
+        std::atomic<int64_t> arrivalIntervalUs_;
+        std::atomic<int64_t> arrivalJitterUs_;
+
+        // Written on the task queue.
+        uint64_t lastCapturedFrame_;
+        std::atomic<uint64_t> capturedFrames_;
+        std::atomic<uint64_t> duplicateTicks_;
+        std::atomic<uint64_t> missedFrames_;
+        std::atomic<int64_t> captureDelayUs_;
     };
 }
 }
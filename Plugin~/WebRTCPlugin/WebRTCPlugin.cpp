@@ -10,6 +10,7 @@
 #include "SetRemoteDescriptionObserver.h"
 #include "UnityAudioTrackSource.h"
 #include "UnityLogStream.h"
+#include "UnityVideoTrackSource.h"
 #include "WebRTCPlugin.h"
 
 namespace unity
@@ -288,6 +289,31 @@ extern "C"
         return source.get();
     }
 
+    UNITY_INTERFACE_EXPORT void VideoTrackSourceSetBufferPoolLimits(
+        UnityVideoTrackSource* source, int32_t maxBufferCount, int64_t staleFrameLimitMs)
+    {
+        RTC_DCHECK_GT(maxBufferCount, 0);
+        RTC_DCHECK_GT(staleFrameLimitMs, 0);
+        source->SetBufferPoolLimits(
+            static_cast<size_t>(maxBufferCount), webrtc::TimeDelta::Millis(staleFrameLimitMs));
+    }
+
+    UNITY_INTERFACE_EXPORT uint64_t VideoTrackSourceGetOverwrittenFrameCount(UnityVideoTrackSource* source)
+    {
+        return source->overwrittenFrameCount();
+    }
+
+    UNITY_INTERFACE_EXPORT uint64_t VideoTrackSourceGetStaticFrameCount(UnityVideoTrackSource* source)
+    {
+        return source->staticFrameCount();
+    }
+
+    UNITY_INTERFACE_EXPORT void
+    VideoTrackSourceGetSchedulerStats(UnityVideoTrackSource* source, VideoFrameSchedulerStats* stats)
+    {
+        *stats = source->GetSchedulerStats();
+    }
+
     UNITY_INTERFACE_EXPORT webrtc::AudioSourceInterface* ContextCreateAudioTrackSource(Context* context)
     {
         rtc::scoped_refptr<AudioSourceInterface> source = context->CreateAudioSource();
@@ -418,6 +444,16 @@ extern "C"
 
     UNITY_INTERFACE_EXPORT uint32_t GetVideoRendererId(UnityVideoRenderer* sink) { return sink->GetId(); }
 
+    UNITY_INTERFACE_EXPORT uint64_t GetVideoRendererDroppedFrameCount(UnityVideoRenderer* sink)
+    {
+        return sink->droppedFrameCount();
+    }
+
+    UNITY_INTERFACE_EXPORT void GetVideoRendererStats(UnityVideoRenderer* sink, VideoRendererStats* stats)
+    {
+        *stats = sink->GetStats();
+    }
+
     UNITY_INTERFACE_EXPORT void DeleteVideoRenderer(Context* context, UnityVideoRenderer* sink)
     {
         context->DeleteVideoRenderer(sink);
@@ -1481,6 +1517,11 @@ extern "C"
         return context->DeleteAudioTrackSinkAdapter(sink);
     }
 
+    UNITY_INTERFACE_EXPORT void ContextGetAudioTickStats(Context* context, AudioTickStats* stats)
+    {
+        *stats = context->GetAudioDevice()->GetTickStats();
+    }
+
     UNITY_INTERFACE_EXPORT void AudioTrackAddSink(AudioTrackInterface* track, AudioTrackSinkInterface* sink)
     {
         track->AddSink(sink);
@@ -1497,6 +1538,16 @@ extern "C"
         sink->ProcessAudio(data, length, static_cast<size_t>(channels), sampleRate);
     }
 
+    UNITY_INTERFACE_EXPORT void AudioTrackSinkGetStats(AudioTrackSinkAdapter* sink, AudioTrackSinkStats* stats)
+    {
+        *stats = sink->GetStats();
+    }
+
+    UNITY_INTERFACE_EXPORT void AudioTrackSinkSetTargetLatency(AudioTrackSinkAdapter* sink, int32_t milliseconds)
+    {
+        sink->SetTargetLatency(milliseconds);
+    }
+
     UNITY_INTERFACE_EXPORT uint32_t FrameGetTimestamp(TransformableFrameInterface* frame)
     {
         return frame->GetTimestamp();
@@ -0,0 +1,118 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "WorkerThreadPool.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    // The number of worker threads. The calling thread also runs the tasks.
+    static constexpr size_t kMaxWorkerThreads = 3;
+
+    struct WorkerThreadPool::Task
+    {
+        Task(int count, std::function<void(int)> func)
+            : func(std::move(func))
+            , count(count)
+            , next(0)
+            , remaining(count)
+        {
+        }
+
+        void Run()
+        {
+            int index;
+            while ((index = next++) < count)
+            {
+                func(index);
+                if (--remaining == 0)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done.notify_all();
+                }
+            }
+        }
+
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this]() { return remaining == 0; });
+        }
+
+        const std::function<void(int)> func;
+        const int count;
+        std::atomic<int> next;
+        std::atomic<int> remaining;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    size_t WorkerThreadPool::DefaultThreadCount()
+    {
+        return std::min(static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1u) - 1), kMaxWorkerThreads);
+    }
+
+    WorkerThreadPool::WorkerThreadPool(size_t numThreads)
+        : quit_(false)
+    {
+        for (size_t i = 0; i < numThreads; i++)
+            threads_.emplace_back(&WorkerThreadPool::WorkerLoop, this);
+    }
+
+    WorkerThreadPool::~WorkerThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            quit_ = true;
+        }
+        cond_.notify_all();
+        for (auto& thread : threads_)
+            thread.join();
+    }
+
+    void WorkerThreadPool::WorkerLoop()
+    {
+        while (true)
+        {
+            std::shared_ptr<Task> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait(lock, [this]() { return quit_ || !queue_.empty(); });
+                if (quit_)
+                    return;
+                task = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            task->Run();
+        }
+    }
+
+    void WorkerThreadPool::ParallelFor(int count, std::function<void(int)> func)
+    {
+        if (count <= 1 || threads_.empty())
+        {
+            for (int i = 0; i < count; i++)
+                func(i);
+            return;
+        }
+
+        auto task = std::make_shared<Task>(count, std::move(func));
+        const size_t helpers = std::min(static_cast<size_t>(count - 1), threads_.size());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < helpers; i++)
+                queue_.push_back(task);
+        }
+        cond_.notify_all();
+
+        // The calling thread takes the tasks too, so the work progresses
+        // even if all workers are busy with the other calls.
+        task->Run();
+        task->Wait();
+    }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace unity
+{
+namespace webrtc
+{
+    // The small thread pool which splits the work of the render thread, e.g. the
+    // conversions of the frames and the textures of the video renderers.
+    // The owner must destroy the pool explicitly before the plugin is unloaded,
+    // because the workers can not be joined during the static destruction on Windows.
+    class WorkerThreadPool
+    {
+    public:
+        // Leaves one core for the calling thread.
+        static size_t DefaultThreadCount();
+
+        explicit WorkerThreadPool(size_t numThreads);
+        ~WorkerThreadPool();
+        WorkerThreadPool(const WorkerThreadPool&) = delete;
+        WorkerThreadPool& operator=(const WorkerThreadPool&) = delete;
+
+        size_t numThreads() const { return threads_.size(); }
+
+        // Runs |func| for each index in [0, count) on the calling thread and the workers.
+        // Returns after all indices are done.
+        void ParallelFor(int count, std::function<void(int)> func);
+
+    private:
+        struct Task;
+
+        void WorkerLoop();
+
+        std::vector<std::thread> threads_;
+        std::mutex mutex_;
+        std::condition_variable cond_;
+        std::deque<std::shared_ptr<Task>> queue_;
+        bool quit_;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,130 @@
+#include "pch.h"
+
+#include <chrono>
+
+#include <common_audio/include/audio_util.h>
+
+#include "AudioChunker.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    static std::vector<float> CreateSine(size_t size)
+    {
+        std::vector<float> data(size);
+        for (size_t i = 0; i < size; i++)
+            data[i] = static_cast<float>(std::sin(static_cast<double>(i) * 0.01));
+        return data;
+    }
+
+    TEST(AudioChunkerTest, FloatToS16)
+    {
+        const std::vector<float> src = { 0.f, 0.5f, -0.5f, 1.f, -1.f, 2.f, -2.f, 1e-5f, -1e-5f, 0.99999f };
+        std::vector<int16_t> dst(src.size());
+        AudioChunker::FloatToS16(src.data(), src.size(), dst.data());
+        for (size_t i = 0; i < src.size(); i++)
+            EXPECT_EQ(::webrtc::FloatToS16(src[i]), dst[i]) << src[i];
+    }
+
+    TEST(AudioChunkerTest, ExactChunks)
+    {
+        const int kSampleRate = 48000;
+        const size_t kChannels = 2;
+        const size_t kFrames = 1024;
+        AudioChunker chunker;
+        chunker.Configure(kSampleRate, kChannels);
+        EXPECT_EQ(480u, chunker.framesPerChunk());
+
+        const std::vector<float> data = CreateSine(kFrames * kChannels * 3);
+        std::vector<int16_t> chunks;
+        std::vector<size_t> remaining;
+        for (size_t i = 0; i < 3; i++)
+        {
+            chunker.Push(
+                data.data() + i * kFrames * kChannels,
+                kFrames,
+                [&](const int16_t* chunk, size_t remainingFrames)
+                {
+                    chunks.insert(chunks.end(), chunk, chunk + chunker.framesPerChunk() * kChannels);
+                    remaining.push_back(remainingFrames);
+                });
+        }
+
+        // All channels of all frames are converted in order.
+        ASSERT_EQ(6u, remaining.size());
+        EXPECT_EQ(kFrames * 3 - 480 * 6, chunker.bufferedFrames());
+        for (size_t i = 0; i < chunks.size(); i++)
+            ASSERT_EQ(::webrtc::FloatToS16(data[i]), chunks[i]) << i;
+        EXPECT_EQ(1024u - 480, remaining[0]);
+        EXPECT_EQ(1024u - 960, remaining[1]);
+        EXPECT_EQ(1024u - 416, remaining[2]);
+    }
+
+    TEST(AudioChunkerTest, ConfigureDropsBufferedFrames)
+    {
+        AudioChunker chunker;
+        chunker.Configure(48000, 2);
+        const std::vector<float> data = CreateSine(100 * 2);
+        int count = 0;
+        chunker.Push(data.data(), 100, [&](const int16_t*, size_t) { count++; });
+        EXPECT_EQ(100u, chunker.bufferedFrames());
+
+        chunker.Configure(48000, 2);
+        EXPECT_EQ(100u, chunker.bufferedFrames());
+        chunker.Configure(16000, 1);
+        EXPECT_EQ(0u, chunker.bufferedFrames());
+        EXPECT_EQ(0, count);
+    }
+
+    class AudioChunkerBenchmark : public testing::TestWithParam<size_t>
+    {
+    };
+
+    // Compares with the vector which erases each chunk from the front.
+    TEST_P(AudioChunkerBenchmark, DISABLED_CompareWithErase)
+    {
+        const int kSampleRate = 48000;
+        const size_t kChannels = 2;
+        const size_t kFrames = GetParam();
+        const size_t kChunkSamples = kSampleRate / 100 * kChannels;
+        const int kIterations = 10000;
+        const std::vector<float> data = CreateSine(kFrames * kChannels);
+        int64_t checksum = 0;
+
+        auto measure = [&](std::function<void()> func)
+        {
+            func();
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < kIterations; i++)
+                func();
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            return std::chrono::duration<double, std::micro>(elapsed).count() / kIterations;
+        };
+
+        std::vector<int16_t> buffer;
+        double erase = measure(
+            [&]()
+            {
+                for (size_t i = 0; i < data.size(); i++)
+                    buffer.push_back(::webrtc::FloatToS16(data[i]));
+                while (buffer.size() >= kChunkSamples)
+                {
+                    checksum += buffer[0];
+                    buffer.erase(buffer.begin(), buffer.begin() + kChunkSamples);
+                }
+            });
+
+        AudioChunker chunker;
+        chunker.Configure(kSampleRate, kChannels);
+        double ring = measure(
+            [&]() { chunker.Push(data.data(), kFrames, [&](const int16_t* chunk, size_t) { checksum += chunk[0]; }); });
+
+        std::printf("%zu frames x %zu channels erase: %.2f us, chunker: %.2f us\n", kFrames, kChannels, erase, ring);
+        EXPECT_NE(0, checksum);
+    }
+
+    INSTANTIATE_TEST_SUITE_P(UnityDspBufferSizes, AudioChunkerBenchmark, testing::Values(1024, 2048, 4096));
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,72 @@
+#include "pch.h"
+
+#include "AudioDriftCompensator.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    class AudioDriftCompensatorTest : public ::testing::Test
+    {
+    protected:
+        static constexpr size_t kChannels = 2;
+
+        size_t Process(std::vector<float>& output, size_t frames)
+        {
+            output.assign(frames * kChannels, 0.f);
+            return compensator_.Process(
+                output.data(),
+                frames,
+                [this](int16_t* data, size_t count)
+                {
+                    count = std::min(count, (input_.size() - read_) / kChannels);
+                    std::copy_n(input_.begin() + read_, count * kChannels, data);
+                    read_ += count * kChannels;
+                    return count;
+                });
+        }
+
+        AudioDriftCompensator compensator_;
+        std::vector<int16_t> input_;
+        size_t read_ = 0;
+    };
+
+    TEST_F(AudioDriftCompensatorTest, PassThroughAtTarget)
+    {
+        for (int16_t i = 0; i < 2000; i++)
+            input_.push_back(i);
+        compensator_.Reset(kChannels, 48000);
+        compensator_.Update(900, 256, 900);
+        EXPECT_EQ(1.0, compensator_.ratio());
+
+        std::vector<float> output;
+        EXPECT_EQ(256u, Process(output, 256));
+        for (size_t i = 0; i < output.size(); i++)
+            ASSERT_EQ(::webrtc::S16ToFloat(static_cast<int16_t>(i)), output[i]) << i;
+
+        // One frame is read ahead for the interpolation.
+        EXPECT_EQ(257 * kChannels, read_);
+    }
+
+    TEST_F(AudioDriftCompensatorTest, StretchByBufferLevel)
+    {
+        input_.assign(48000 * kChannels, 1000);
+        compensator_.Reset(kChannels, 48000);
+
+        // The buffer is 10 ms above the target, so the audio is consumed faster.
+        compensator_.Update(1440, 480, 960);
+        EXPECT_LT(1.0, compensator_.ratio());
+        EXPECT_GE(1.0 + AudioDriftCompensator::kMaxCorrection, compensator_.ratio());
+        EXPECT_LT(0.0, compensator_.drift());
+
+        std::vector<float> output;
+        const size_t kFrames = 4800;
+        EXPECT_EQ(kFrames, Process(output, kFrames));
+        EXPECT_LT(kFrames + 1, read_ / kChannels);
+
+        // The input runs out.
+        EXPECT_GT(48000u, Process(output, 48000));
+    }
+
+} // end namespace webrtc
+} // end namespace unity
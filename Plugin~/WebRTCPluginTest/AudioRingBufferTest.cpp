@@ -0,0 +1,71 @@
+#include "pch.h"
+
+#include <thread>
+
+#include "AudioRingBuffer.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    TEST(AudioRingBufferTest, WriteAndRead)
+    {
+        AudioRingBuffer ring(8);
+        const int16_t input[] = { 1, 2, 3, 4, 5, 6 };
+        int16_t output[8] = {};
+
+        EXPECT_EQ(6u, ring.Write(input, 6));
+        EXPECT_EQ(4u, ring.Read(output, 4));
+        EXPECT_EQ(2u, ring.size());
+
+        // The write wraps around the end of the ring.
+        EXPECT_EQ(6u, ring.Write(input, 6));
+        EXPECT_EQ(8u, ring.Read(output, 8));
+        const int16_t expected[] = { 5, 6, 1, 2, 3, 4, 5, 6 };
+        for (size_t i = 0; i < 8; i++)
+            EXPECT_EQ(expected[i], output[i]);
+        EXPECT_EQ(0u, ring.Read(output, 8));
+    }
+
+    TEST(AudioRingBufferTest, WriteOnlyWhatFits)
+    {
+        AudioRingBuffer ring(8);
+        const int16_t input[] = { 1, 2, 3, 4, 5, 6 };
+        EXPECT_EQ(6u, ring.Write(input, 6));
+        EXPECT_EQ(2u, ring.Write(input, 6));
+        EXPECT_EQ(0u, ring.Write(input, 6));
+        EXPECT_EQ(8u, ring.size());
+    }
+
+    TEST(AudioRingBufferTest, ConcurrentWriteAndRead)
+    {
+        const int16_t kCount = 30000;
+        AudioRingBuffer ring(64);
+
+        std::thread producer(
+            [&]()
+            {
+                int16_t value = 0;
+                while (value < kCount)
+                {
+                    int16_t block[7];
+                    for (int16_t i = 0; i < 7; i++)
+                        block[i] = value + i;
+                    value += static_cast<int16_t>(ring.Write(block, std::min<size_t>(7, kCount - value)));
+                }
+            });
+
+        // The consumer receives all samples in order.
+        int16_t expected = 0;
+        while (expected < kCount)
+        {
+            int16_t block[5];
+            const size_t count = ring.Read(block, 5);
+            for (size_t i = 0; i < count; i++)
+                ASSERT_EQ(expected++, block[i]);
+        }
+        producer.join();
+    }
+
+} // end namespace webrtc
+} // end namespace unity
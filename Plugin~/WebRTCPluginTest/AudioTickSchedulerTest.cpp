@@ -0,0 +1,76 @@
+#include "pch.h"
+
+#include "AudioTickScheduler.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    const TimeDelta kPeriod = TimeDelta::Millis(10);
+    const int kMaxCatchUpTicks = 5;
+
+    TEST(AudioTickSchedulerTest, KeepDeadlines)
+    {
+        AudioTickScheduler scheduler(kPeriod, kMaxCatchUpTicks);
+        Timestamp start = Timestamp::Millis(1000);
+        scheduler.Start(start);
+
+        // The delay of the tick does not shift the next deadline.
+        EXPECT_EQ(start + kPeriod, scheduler.OnTick(start));
+        EXPECT_EQ(start + kPeriod * 2, scheduler.OnTick(start + TimeDelta::Millis(13)));
+        EXPECT_EQ(start + kPeriod * 3, scheduler.OnTick(start + TimeDelta::Millis(20)));
+
+        AudioTickStats stats = scheduler.GetStats();
+        EXPECT_EQ(3u, stats.ticks);
+        EXPECT_EQ(0u, stats.lateTicks);
+        EXPECT_EQ(0u, stats.skippedTicks);
+        EXPECT_DOUBLE_EQ(3.0, stats.maxJitterMs);
+        EXPECT_EQ(2u, stats.histogram[0]);
+        // 3 ms is in the bucket of 2 ms to 5 ms.
+        EXPECT_EQ(1u, stats.histogram[4]);
+    }
+
+    TEST(AudioTickSchedulerTest, CatchUp)
+    {
+        AudioTickScheduler scheduler(kPeriod, kMaxCatchUpTicks);
+        Timestamp start = Timestamp::Millis(1000);
+        scheduler.Start(start);
+
+        // The tick stalls for 35 ms, the missed ticks run back to back.
+        Timestamp now = start + TimeDelta::Millis(35);
+        EXPECT_GE(now, scheduler.OnTick(now));
+        EXPECT_GE(now, scheduler.OnTick(now));
+        EXPECT_GE(now, scheduler.OnTick(now));
+        EXPECT_EQ(now + TimeDelta::Millis(5), scheduler.OnTick(now));
+
+        AudioTickStats stats = scheduler.GetStats();
+        EXPECT_EQ(4u, stats.ticks);
+        EXPECT_EQ(3u, stats.lateTicks);
+        EXPECT_EQ(0u, stats.skippedTicks);
+        EXPECT_DOUBLE_EQ(35.0, stats.maxJitterMs);
+        // 35 ms and 25 ms are in the last bucket.
+        EXPECT_EQ(2u, stats.histogram[kAudioTickHistogramSize - 1]);
+    }
+
+    TEST(AudioTickSchedulerTest, SkipLongStall)
+    {
+        AudioTickScheduler scheduler(kPeriod, kMaxCatchUpTicks);
+        Timestamp start = Timestamp::Millis(1000);
+        scheduler.Start(start);
+
+        // The tick stalls for 1 second. Only the ticks of the last 50 ms are caught up.
+        Timestamp now = start + TimeDelta::Millis(1003);
+        int ticks = 1;
+        Timestamp deadline = Timestamp::MinusInfinity();
+        while ((deadline = scheduler.OnTick(now)) <= now)
+            ticks++;
+        EXPECT_EQ(kMaxCatchUpTicks + 1, ticks);
+        // The phase of the deadlines is kept.
+        EXPECT_EQ(now + TimeDelta::Millis(7), deadline);
+
+        AudioTickStats stats = scheduler.GetStats();
+        EXPECT_EQ(95u, stats.skippedTicks);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,102 @@
+#include "pch.h"
+
+#include "AudioTrackSinkAdapter.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    class AudioTrackSinkAdapterTest : public ::testing::Test
+    {
+    protected:
+        static constexpr int kSampleRate = 48000;
+        static constexpr size_t kChannels = 2;
+        static constexpr size_t kFramesFor10ms = kSampleRate / 100;
+
+        void SendChunk()
+        {
+            std::vector<int16_t> chunk(kFramesFor10ms * kChannels, 1000);
+            sink_.OnData(chunk.data(), 16, kSampleRate, kChannels, kFramesFor10ms);
+        }
+
+        size_t ReceiveAudio(size_t length)
+        {
+            std::vector<float> data(length, 1.f);
+            sink_.ProcessAudio(data.data(), length, kChannels, kSampleRate);
+            return static_cast<size_t>(std::count_if(data.begin(), data.end(), [](float v) { return v != 0.f; }));
+        }
+
+        AudioTrackSinkAdapter sink_;
+    };
+
+    TEST_F(AudioTrackSinkAdapterTest, Underrun)
+    {
+        // The audio is dropped until Unity requests the format.
+        SendChunk();
+        EXPECT_EQ(0u, ReceiveAudio(1024));
+
+        // Silence until the ring fills up to the target, which is one read
+        // of 512 frames plus one chunk, longer than the default target.
+        SendChunk();
+        SendChunk();
+        EXPECT_EQ(0u, ReceiveAudio(1024));
+        EXPECT_EQ(0u, sink_.GetStats().underruns);
+
+        // 2.8 reads of 512 frames are buffered.
+        SendChunk();
+        for (int i = 0; i < 2; i++)
+            EXPECT_EQ(1024u, ReceiveAudio(1024));
+        EXPECT_EQ(0u, sink_.GetStats().underruns);
+
+        EXPECT_GT(1024u, ReceiveAudio(1024));
+        EXPECT_EQ(1u, sink_.GetStats().underruns);
+
+        // The late chunk is played at once.
+        SendChunk();
+        EXPECT_LT(0u, ReceiveAudio(1024));
+
+        // Silence until the target again after the ring runs empty.
+        EXPECT_EQ(0u, ReceiveAudio(1024));
+        SendChunk();
+        EXPECT_EQ(0u, ReceiveAudio(1024));
+    }
+
+    TEST_F(AudioTrackSinkAdapterTest, HoldTargetLatency)
+    {
+        // The clock of WebRTC is 1000 ppm faster than the clock of Unity.
+        const size_t kReadFrames = 1024;
+        const double kProducedFramesPerRead = kReadFrames * 1.001;
+        ReceiveAudio(kReadFrames * kChannels);
+
+        double produced = 0.0;
+        for (int i = 0; i < 60 * kSampleRate / static_cast<int>(kReadFrames); i++)
+        {
+            for (produced += kProducedFramesPerRead; produced >= kFramesFor10ms; produced -= kFramesFor10ms)
+                SendChunk();
+            ReceiveAudio(kReadFrames * kChannels);
+        }
+
+        // The latency doesn't grow after one minute.
+        AudioTrackSinkStats stats = sink_.GetStats();
+        EXPECT_EQ(0u, stats.underruns);
+        EXPECT_EQ(0u, stats.overruns);
+        // The target is one read plus one chunk, longer than the default target.
+        const double targetMs = (kReadFrames + kFramesFor10ms) * 1000.0 / kSampleRate;
+        EXPECT_NEAR(targetMs, stats.bufferedMs, 10.0);
+        EXPECT_NEAR(1000.0, stats.driftPpm, 200.0);
+    }
+
+    TEST_F(AudioTrackSinkAdapterTest, Overrun)
+    {
+        ReceiveAudio(1024);
+
+        // The ring holds 200 ms of the audio.
+        const int kChunkCount = 25;
+        for (int i = 0; i < kChunkCount; i++)
+            SendChunk();
+        EXPECT_EQ(5u, sink_.GetStats().overruns);
+        EXPECT_EQ(0u, sink_.GetStats().underruns);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
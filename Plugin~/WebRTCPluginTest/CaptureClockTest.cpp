@@ -0,0 +1,30 @@
+#include "pch.h"
+
+#include "CaptureClock.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    TEST(CaptureClockTest, ToNtpTimeMs)
+    {
+        SimulatedClock simulatedClock(Timestamp::Seconds(100));
+        CaptureClock clock(&simulatedClock);
+        EXPECT_EQ(simulatedClock.CurrentTime(), clock.CurrentTime());
+        EXPECT_EQ(simulatedClock.CurrentNtpInMilliseconds(), clock.ToNtpTimeMs(clock.CurrentTime()));
+
+        simulatedClock.AdvanceTime(TimeDelta::Millis(1500));
+        EXPECT_EQ(simulatedClock.CurrentNtpInMilliseconds(), clock.ToNtpTimeMs(clock.CurrentTime()));
+    }
+
+    TEST(CaptureClockTest, GetInstance)
+    {
+        const CaptureClock& clock = CaptureClock::GetInstance();
+        EXPECT_EQ(&clock, &CaptureClock::GetInstance());
+        const Timestamp now = clock.CurrentTime();
+        EXPECT_LE(now, clock.CurrentTime());
+        EXPECT_EQ(clock.ToNtpTimeMs(now) + 20, clock.ToNtpTimeMs(now + TimeDelta::Millis(20)));
+    }
+
+} // end namespace webrtc
+} // end namespace unity
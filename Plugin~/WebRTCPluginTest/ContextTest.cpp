@@ -69,6 +69,25 @@ namespace webrtc
         EXPECT_NE(nullptr, track);
     }
 
+    TEST_P(ContextTest, RemoveVideoSource)
+    {
+        auto source = context->CreateVideoSource();
+        auto other = context->CreateVideoSource();
+        EXPECT_NE(source->id(), other->id());
+        context->AddRefPtr(source);
+        context->AddRefPtr(other);
+        EXPECT_TRUE(context->TakeRemovedVideoSourceIds().empty());
+
+        // The buffer pool of the source is released by the id, not by the address.
+        const uint64_t id = source->id();
+        context->RemoveRefPtr(source);
+        std::vector<uint64_t> ids = context->TakeRemovedVideoSourceIds();
+        ASSERT_EQ(1u, ids.size());
+        EXPECT_EQ(id, ids[0]);
+        EXPECT_TRUE(context->TakeRemovedVideoSourceIds().empty());
+        context->RemoveRefPtr(other);
+    }
+
     TEST_P(ContextTest, CreateAndDeleteMediaStream)
     {
         const auto stream = context->CreateMediaStream("test");
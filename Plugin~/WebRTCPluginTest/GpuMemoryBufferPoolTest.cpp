@@ -65,6 +65,27 @@ namespace webrtc
         EXPECT_EQ(1u, bufferPool_->bufferCount());
     }
 
+    TEST_P(GpuMemoryBufferPoolTest, ReturnBufferWhenCopyFailed)
+    {
+        // Only the software device rejects the null pointer safely.
+        if (device_->GetGfxRenderer() != kUnityGfxRendererNull)
+            GTEST_SKIP() << "The copy from the invalid pointer is not defined on this device.";
+
+        const Size kSize(kWidth, kHeight);
+        EXPECT_EQ(nullptr, bufferPool_->CreateFrame(nullptr, kSize, kFormat, clock_.CurrentTime()));
+        EXPECT_EQ(1u, bufferPool_->bufferCount());
+        // The failed frame is not counted.
+        EXPECT_EQ(0u, bufferPool_->missCount());
+
+        // The buffer is back in the pool, and reused for the next frame.
+        auto tex = CreateTexture(kSize, kFormat);
+        auto frame = bufferPool_->CreateFrame(tex->GetNativeTexturePtrV(), kSize, kFormat, clock_.CurrentTime());
+        EXPECT_NE(nullptr, frame);
+        EXPECT_EQ(1u, bufferPool_->bufferCount());
+        EXPECT_EQ(1u, bufferPool_->hitCount());
+        EXPECT_EQ(0u, bufferPool_->missCount());
+    }
+
     TEST_P(GpuMemoryBufferPoolTest, ReuseFirstResource)
     {
         const Size kSize(kWidth, kHeight);
@@ -88,6 +109,31 @@ namespace webrtc
         EXPECT_EQ(2u, bufferPool_->bufferCount());
     }
 
+    TEST_P(GpuMemoryBufferPoolTest, ReuseLeastRecentlyUsedBuffer)
+    {
+        const Size kSize(kWidth, kHeight);
+        auto tex = CreateTexture(kSize, kFormat);
+        void* ptr = tex->GetNativeTexturePtrV();
+
+        auto frame1 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime());
+        auto frame2 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime());
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        ASSERT_NE(frame1, nullptr);
+        ASSERT_NE(frame2, nullptr);
+        auto buffer1 = frame1->GetGpuMemoryBuffer();
+
+        // The buffer which was returned first is reused first.
+        frame1 = nullptr;
+        clock_.AdvanceTime(TimeDelta::Millis(10));
+        frame2 = nullptr;
+        auto frame3 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime());
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        ASSERT_NE(frame3, nullptr);
+        EXPECT_EQ(buffer1, frame3->GetGpuMemoryBuffer());
+        EXPECT_EQ(1u, bufferPool_->hitCount());
+        EXPECT_EQ(2u, bufferPool_->missCount());
+    }
+
     TEST_P(GpuMemoryBufferPoolTest, DropResourceWhenSizeIsDifferent)
     {
         const Size kSize1(kWidth, kHeight);
@@ -142,6 +188,113 @@ namespace webrtc
         EXPECT_EQ(0u, bufferPool_->bufferCount());
     }
 
+    TEST_P(GpuMemoryBufferPoolTest, CountHitsAndMisses)
+    {
+        const Size kSize1(kWidth, kHeight);
+        auto tex1 = CreateTexture(kSize1, kFormat);
+        void* ptr1 = tex1->GetNativeTexturePtrV();
+
+        const Size kSize2(512, 512);
+        auto tex2 = CreateTexture(kSize2, kFormat);
+        void* ptr2 = tex2->GetNativeTexturePtrV();
+
+        auto frame1 = bufferPool_->CreateFrame(ptr1, kSize1, kFormat, clock_.CurrentTime());
+        auto frame2 = bufferPool_->CreateFrame(ptr2, kSize2, kFormat, clock_.CurrentTime());
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_EQ(0u, bufferPool_->hitCount());
+        EXPECT_EQ(2u, bufferPool_->missCount());
+
+        frame1 = nullptr;
+
+        // The buffer which has the same size is reused.
+        auto frame3 = bufferPool_->CreateFrame(ptr1, kSize1, kFormat, clock_.CurrentTime());
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_EQ(1u, bufferPool_->hitCount());
+        EXPECT_EQ(2u, bufferPool_->missCount());
+
+        // The returned buffer has a different size, so it is not reused.
+        frame2 = nullptr;
+        auto frame4 = bufferPool_->CreateFrame(ptr1, kSize1, kFormat, clock_.CurrentTime());
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_EQ(1u, bufferPool_->hitCount());
+        EXPECT_EQ(3u, bufferPool_->missCount());
+        EXPECT_EQ(3u, bufferPool_->bufferCount());
+    }
+
+    TEST_P(GpuMemoryBufferPoolTest, DropFrameWhenReachedLimit)
+    {
+        const Size kSize(kWidth, kHeight);
+        auto tex = CreateTexture(kSize, kFormat);
+        void* ptr = tex->GetNativeTexturePtrV();
+
+        bufferPool_->SetMaxBufferCount(1);
+        EXPECT_EQ(1u, bufferPool_->maxBufferCount());
+
+        auto frame1 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime());
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_NE(frame1, nullptr);
+
+        // No free buffer and the pool is full.
+        auto frame2 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime());
+        EXPECT_EQ(frame2, nullptr);
+        EXPECT_EQ(1u, bufferPool_->bufferCount());
+
+        frame1 = nullptr;
+        auto frame3 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime());
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_NE(frame3, nullptr);
+        EXPECT_EQ(1u, bufferPool_->bufferCount());
+    }
+
+    TEST_P(GpuMemoryBufferPoolTest, ChangeSizeAtLimit)
+    {
+        const Size kSize1(kWidth, kHeight);
+        auto tex1 = CreateTexture(kSize1, kFormat);
+        const Size kSize2(512, 512);
+        auto tex2 = CreateTexture(kSize2, kFormat);
+
+        bufferPool_->SetMaxBufferCount(1);
+        auto frame1 = bufferPool_->CreateFrame(tex1->GetNativeTexturePtrV(), kSize1, kFormat, clock_.CurrentTime());
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_NE(frame1, nullptr);
+
+        // The buffer of the other size is still used.
+        auto frame2 = bufferPool_->CreateFrame(tex2->GetNativeTexturePtrV(), kSize2, kFormat, clock_.CurrentTime());
+        EXPECT_EQ(frame2, nullptr);
+        EXPECT_EQ(1u, bufferPool_->bufferCount());
+
+        // The free buffer of the other size is released for the new size.
+        frame1 = nullptr;
+        frame2 = bufferPool_->CreateFrame(tex2->GetNativeTexturePtrV(), kSize2, kFormat, clock_.CurrentTime());
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        ASSERT_NE(frame2, nullptr);
+        EXPECT_EQ(kSize2, frame2->size());
+        EXPECT_EQ(1u, bufferPool_->bufferCount());
+    }
+
+    TEST_P(GpuMemoryBufferPoolTest, Prewarm)
+    {
+        const Size kSize(kWidth, kHeight);
+        auto tex = CreateTexture(kSize, kFormat);
+        void* ptr = tex->GetNativeTexturePtrV();
+
+        bufferPool_->SetMaxBufferCount(3);
+        EXPECT_EQ(2u, bufferPool_->Prewarm(kSize, kFormat, 2));
+        EXPECT_EQ(2u, bufferPool_->bufferCount());
+
+        // Never exceed the limit.
+        EXPECT_EQ(1u, bufferPool_->Prewarm(kSize, kFormat, 2));
+        EXPECT_EQ(3u, bufferPool_->bufferCount());
+
+        // The first frame reuses the prewarmed buffer.
+        auto frame = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime());
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_NE(frame, nullptr);
+        EXPECT_EQ(1u, bufferPool_->hitCount());
+        EXPECT_EQ(0u, bufferPool_->missCount());
+        EXPECT_EQ(3u, bufferPool_->bufferCount());
+    }
+
     INSTANTIATE_TEST_SUITE_P(GfxDevice, GpuMemoryBufferPoolTest, testing::ValuesIn(supportedGfxDevices));
 
 } // end namespace webrtc
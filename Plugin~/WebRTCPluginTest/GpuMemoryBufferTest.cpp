@@ -1,5 +1,7 @@
 #include "pch.h"
 
+#include <api/make_ref_counted.h>
+
 #include "GpuMemoryBuffer.h"
 #include "GraphicsDevice/IGraphicsDevice.h"
 #include "GraphicsDevice/ITexture2D.h"
@@ -92,6 +94,249 @@ namespace webrtc
         }
     }
 
+    TEST_P(GpuMemoryBufferTest, ScaleSimulcastLayers)
+    {
+        const Size kLayers[] = { Size(kWidth / 4, kHeight / 4), Size(kWidth / 2, kHeight / 2), Size(kWidth, kHeight) };
+        std::unique_ptr<const ITexture2D> texture(device_->CreateDefaultTextureV(kWidth, kHeight, kFormat));
+        auto history = std::make_shared<ScaledLayerHistory>();
+
+        // The second frame builds all layers which were requested for the first frame at once.
+        for (int i = 0; i < 2; i++)
+        {
+            auto testFrame = CreateTestFrame(device_, texture.get(), kFormat);
+            EXPECT_TRUE(device_->WaitIdleForTest());
+            auto adapter = rtc::make_ref_counted<VideoFrameAdapter>(testFrame, history);
+
+            // From the lowest layer like SimulcastEncoderAdapter.
+            for (const Size& layer : kLayers)
+            {
+                auto scaled = adapter->Scale(layer.width(), layer.height());
+                auto i420Buffer = scaled->ToI420();
+                ASSERT_NE(i420Buffer, nullptr);
+                EXPECT_EQ(i420Buffer->width(), layer.width());
+                EXPECT_EQ(i420Buffer->height(), layer.height());
+            }
+        }
+        EXPECT_EQ(3u, history->Get(kSize).size());
+    }
+
+    TEST(ScaledLayerHistoryTest, ForgetUnusedLayers)
+    {
+        const Size kFrameSize(1280, 720);
+        ScaledLayerHistory history;
+        auto layer = [&](int width, int height)
+        {
+            ScaledLayerKey key;
+            key.cropWidth = kFrameSize.width();
+            key.cropHeight = kFrameSize.height();
+            key.size = Size(width, height);
+            return key;
+        };
+
+        // The adaptation changes the resolution more often than the history holds.
+        for (int i = 0; i < 2 * static_cast<int>(kMaxScaledLayers); i++)
+        {
+            history.NextFrame();
+            history.Add(kFrameSize, layer(640 - i * 16, 360 - i * 9));
+        }
+        auto layers = history.Get(kFrameSize);
+        ASSERT_EQ(kMaxScaledLayers, layers.size());
+        // The latest layer replaced the oldest one.
+        EXPECT_NE(std::find(layers.begin(), layers.end(), layer(640 - 15 * 16, 360 - 15 * 9)), layers.end());
+        EXPECT_EQ(std::find(layers.begin(), layers.end(), layer(640, 360)), layers.end());
+
+        // The layers which are not requested any more are removed.
+        for (uint64_t i = 0; i < ScaledLayerHistory::kMaxUnusedFrames; i++)
+        {
+            history.NextFrame();
+            history.Add(kFrameSize, layer(320, 180));
+        }
+        history.NextFrame();
+        layers = history.Get(kFrameSize);
+        ASSERT_EQ(1u, layers.size());
+        EXPECT_EQ(layer(320, 180), layers[0]);
+    }
+
+    TEST_P(GpuMemoryBufferTest, CropAndScaleWithOffset)
+    {
+        std::unique_ptr<const ITexture2D> texture(device_->CreateDefaultTextureV(kWidth, kHeight, kFormat));
+        auto testFrame = CreateTestFrame(device_, texture.get(), kFormat);
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        auto adapter = rtc::make_ref_counted<VideoFrameAdapter>(testFrame);
+        auto source = adapter->ToI420();
+        ASSERT_NE(source, nullptr);
+        const int width = static_cast<int>(kWidth);
+        const int height = static_cast<int>(kHeight);
+
+        // Cropping without scaling returns the view of the original planes.
+        const int kOffsetX = width / 4;
+        const int kOffsetY = height / 4;
+        auto cropped = adapter->CropAndScale(kOffsetX, kOffsetY, width / 2, height / 2, width / 2, height / 2);
+        auto croppedI420 = cropped->ToI420();
+        ASSERT_NE(croppedI420, nullptr);
+        EXPECT_EQ(width / 2, croppedI420->width());
+        EXPECT_EQ(height / 2, croppedI420->height());
+        EXPECT_EQ(source->DataY() + source->StrideY() * kOffsetY + kOffsetX, croppedI420->DataY());
+
+        // The nested crop is mapped to the region of the original frame.
+        auto nested = cropped->CropAndScale(0, 0, width / 4, height / 4, width / 8, height / 8);
+        auto nestedI420 = nested->ToI420();
+        ASSERT_NE(nestedI420, nullptr);
+        EXPECT_EQ(width / 8, nestedI420->width());
+        EXPECT_EQ(height / 8, nestedI420->height());
+    }
+
+    TEST_P(GpuMemoryBufferTest, CropWithOddOffset)
+    {
+        std::unique_ptr<const ITexture2D> texture(device_->CreateDefaultTextureV(kWidth, kHeight, kFormat));
+        auto testFrame = CreateTestFrame(device_, texture.get(), kFormat);
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        auto adapter = rtc::make_ref_counted<VideoFrameAdapter>(testFrame);
+        auto source = adapter->ToI420();
+        ASSERT_NE(source, nullptr);
+        const int width = static_cast<int>(kWidth);
+        const int height = static_cast<int>(kHeight);
+
+        // The region is aligned to the even pixels, so that the chroma planes start at the same pixel.
+        const int kOffsetX = width / 4;
+        const int kOffsetY = height / 4;
+        auto cropped =
+            adapter->CropAndScale(kOffsetX + 1, kOffsetY + 1, width / 2 + 1, height / 2 + 1, width / 2, height / 2);
+        auto croppedI420 = cropped->ToI420();
+        ASSERT_NE(croppedI420, nullptr);
+        EXPECT_EQ(width / 2, croppedI420->width());
+        EXPECT_EQ(height / 2, croppedI420->height());
+        EXPECT_EQ(source->DataY() + source->StrideY() * kOffsetY + kOffsetX, croppedI420->DataY());
+        EXPECT_EQ(source->DataU() + source->StrideU() * (kOffsetY / 2) + kOffsetX / 2, croppedI420->DataU());
+        EXPECT_EQ(source->DataV() + source->StrideV() * (kOffsetY / 2) + kOffsetX / 2, croppedI420->DataV());
+    }
+
+    TEST_P(GpuMemoryBufferTest, MapToNV12)
+    {
+        std::unique_ptr<const ITexture2D> texture(device_->CreateDefaultTextureV(kWidth, kHeight, kFormat));
+        auto testFrame = CreateTestFrame(device_, texture.get(), kFormat);
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        auto adapter = rtc::make_ref_counted<VideoFrameAdapter>(testFrame);
+
+        VideoFrameBuffer::Type types[] = { VideoFrameBuffer::Type::kI420, VideoFrameBuffer::Type::kNV12 };
+        auto mapped = adapter->GetMappedFrameBuffer(types);
+        ASSERT_NE(mapped, nullptr);
+        EXPECT_EQ(VideoFrameBuffer::Type::kNV12, mapped->type());
+        EXPECT_EQ(static_cast<int>(kWidth), mapped->width());
+        EXPECT_EQ(static_cast<int>(kHeight), mapped->height());
+
+        // The converted buffer is reused.
+        EXPECT_EQ(mapped, adapter->GetMappedFrameBuffer(types));
+        EXPECT_NE(adapter->ToI420(), nullptr);
+    }
+
+    TEST_P(GpuMemoryBufferTest, CopyOnlyIntoReadTexture)
+    {
+        std::unique_ptr<ITexture2D> texture(device_->CreateDefaultTextureV(kWidth, kHeight, kFormat));
+        void* ptr = texture->GetNativeTexturePtrV();
+        auto buffer = rtc::make_ref_counted<GpuMemoryBufferFromUnity>(device_, kSize, kFormat);
+
+        // The consumer is not known yet, so both textures are copied.
+        EXPECT_TRUE(buffer->CopyBuffer(ptr));
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_EQ(GpuMemoryBufferFromUnity::kUsageAll, buffer->copiedUsage());
+        EXPECT_NE(buffer->ToI420(), nullptr);
+
+        // The previous frame was read by ToI420.
+        EXPECT_TRUE(buffer->ResetSync());
+        EXPECT_TRUE(buffer->CopyBuffer(ptr));
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_EQ(GpuMemoryBufferFromUnity::kUsageCpuRead, buffer->copiedUsage());
+        EXPECT_NE(buffer->ToI420(), nullptr);
+
+        // The native handle requires the fallback copy.
+        buffer->handle();
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        const uint32_t copiedUsage = device_->CanCopyResourceOnWorkerThread()
+            ? GpuMemoryBufferFromUnity::kUsageAll
+            : GpuMemoryBufferFromUnity::kUsageCpuRead;
+        EXPECT_EQ(copiedUsage, buffer->copiedUsage());
+
+        // Both paths were read by the previous frame.
+        EXPECT_TRUE(buffer->ResetSync());
+        EXPECT_TRUE(buffer->CopyBuffer(ptr));
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_EQ(GpuMemoryBufferFromUnity::kUsageAll, buffer->copiedUsage());
+    }
+
+    TEST_P(GpuMemoryBufferTest, SwitchFromNativeHandleToI420)
+    {
+        std::unique_ptr<ITexture2D> texture(device_->CreateDefaultTextureV(kWidth, kHeight, kFormat));
+        void* ptr = texture->GetNativeTexturePtrV();
+        auto buffer = rtc::make_ref_counted<GpuMemoryBufferFromUnity>(device_, kSize, kFormat);
+
+        // The first frame is read only through the native handle.
+        EXPECT_TRUE(buffer->CopyBuffer(ptr));
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        buffer->handle();
+        EXPECT_TRUE(buffer->ResetSync());
+        EXPECT_TRUE(buffer->CopyBuffer(ptr));
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_EQ(GpuMemoryBufferFromUnity::kUsageNativeHandle, buffer->copiedUsage());
+
+        // The consumer switches to ToI420. The device which copies only on the
+        // render thread drops the frame instead of reading the stale texture.
+        auto i420Buffer = buffer->ToI420();
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        if (device_->CanCopyResourceOnWorkerThread())
+        {
+            EXPECT_NE(i420Buffer, nullptr);
+            EXPECT_EQ(GpuMemoryBufferFromUnity::kUsageAll, buffer->copiedUsage());
+        }
+        else
+        {
+            EXPECT_EQ(i420Buffer, nullptr);
+            EXPECT_EQ(GpuMemoryBufferFromUnity::kUsageNativeHandle, buffer->copiedUsage());
+        }
+
+        // The next frame is copied into the texture for ToI420 on every device.
+        EXPECT_TRUE(buffer->ResetSync());
+        EXPECT_TRUE(buffer->CopyBuffer(ptr));
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_EQ(GpuMemoryBufferFromUnity::kUsageCpuRead, buffer->copiedUsage());
+        EXPECT_NE(buffer->ToI420(), nullptr);
+    }
+
+    TEST_P(GpuMemoryBufferTest, PeekI420WithoutCpuRead)
+    {
+        std::unique_ptr<ITexture2D> texture(device_->CreateDefaultTextureV(kWidth, kHeight, kFormat));
+        void* ptr = texture->GetNativeTexturePtrV();
+        auto buffer = rtc::make_ref_counted<GpuMemoryBufferFromUnity>(device_, kSize, kFormat);
+
+        // The first frame is copied into both textures, and peeking converts the CPU readable copy.
+        EXPECT_TRUE(buffer->CopyBuffer(ptr));
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        auto peeked = buffer->PeekI420();
+        ASSERT_NE(peeked, nullptr);
+        EXPECT_EQ(static_cast<int>(kWidth), peeked->width());
+        buffer->handle();
+
+        // Peeking is not counted as the read, so only the native handle is copied.
+        EXPECT_TRUE(buffer->ResetSync());
+        EXPECT_TRUE(buffer->CopyBuffer(ptr));
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_EQ(GpuMemoryBufferFromUnity::kUsageNativeHandle, buffer->copiedUsage());
+        EXPECT_EQ(buffer->PeekI420(), nullptr);
+        EXPECT_EQ(GpuMemoryBufferFromUnity::kUsageNativeHandle, buffer->copiedUsage());
+
+        // ToI420 reuses the peeked buffer and is counted.
+        EXPECT_TRUE(buffer->ResetSync());
+        EXPECT_TRUE(buffer->CopyBuffer(ptr));
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_NE(buffer->ToI420(), nullptr);
+        EXPECT_TRUE(buffer->ResetSync());
+        EXPECT_TRUE(buffer->CopyBuffer(ptr));
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        peeked = buffer->PeekI420();
+        ASSERT_NE(peeked, nullptr);
+        EXPECT_EQ(peeked, buffer->ToI420());
+    }
+
     INSTANTIATE_TEST_SUITE_P(GfxDevice, GpuMemoryBufferTest, testing::ValuesIn(supportedGfxDevices));
 
 } // end namespace webrtc
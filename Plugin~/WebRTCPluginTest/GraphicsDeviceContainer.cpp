@@ -516,7 +516,8 @@ namespace webrtc
         renderer_ = renderer;
 
         // native graphics device is not initialized.
-        if (!nativeGfxDevice_)
+        // The software graphics device doesn't need the native device.
+        if (!nativeGfxDevice_ && renderer != kUnityGfxRendererNull)
             return;
 
         IGraphicsDevice* device = nullptr;
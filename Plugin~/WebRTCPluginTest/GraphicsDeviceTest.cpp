@@ -5,6 +5,8 @@
 #include "GpuMemoryBuffer.h"
 #include "GraphicsDevice/IGraphicsDevice.h"
 #include "GraphicsDevice/ITexture2D.h"
+#include "GraphicsDevice/Software/SoftwareGraphicsDevice.h"
+#include "GraphicsDevice/Software/SoftwareTexture2D.h"
 #include "GraphicsDeviceTestBase.h"
 
 namespace unity
@@ -99,6 +101,25 @@ namespace webrtc
         EXPECT_TRUE(device()->WaitIdleForTest());
     }
 
+    TEST_P(GraphicsDeviceTest, WaitSyncOnOtherThread)
+    {
+        const uint32_t width = 256;
+        const uint32_t height = 256;
+        const std::unique_ptr<ITexture2D> src(device()->CreateDefaultTextureV(width, height, format()));
+        const std::unique_ptr<ITexture2D> dst(device()->CreateCPUReadTextureV(width, height, format()));
+        EXPECT_TRUE(device()->WaitIdleForTest());
+        EXPECT_TRUE(device()->CopyResourceFromNativeV(dst.get(), src->GetNativeTexturePtrV()));
+
+        // The copy is waited on the thread which reads the texture.
+        std::unique_ptr<rtc::Thread> thread = rtc::Thread::CreateWithSocketServer();
+        thread->Start();
+        using namespace std::chrono_literals;
+        const std::chrono::nanoseconds timeout(1s);
+        bool signaled = thread->BlockingCall([&]() { return device()->WaitSync(dst.get(), timeout.count()); });
+        EXPECT_TRUE(signaled);
+        EXPECT_TRUE(device()->ResetSync(dst.get()));
+    }
+
     TEST_P(GraphicsDeviceTest, ConvertRGBToI420)
     {
         const uint32_t width = 256;
@@ -146,6 +167,31 @@ namespace webrtc
         std::unique_ptr<GpuMemoryBufferHandle> handle2 = device()->Map(src2.get());
     }
 
+    TEST(SoftwareGraphicsDeviceTest, CopyResourceFromTextureData)
+    {
+        const uint32_t width = 16;
+        const uint32_t height = 16;
+        const int pitch = static_cast<int>(width * 4);
+        SoftwareGraphicsDevice device(kUnityGfxRendererNull, nullptr);
+        const std::unique_ptr<ITexture2D> dst(
+            device.CreateDefaultTextureV(width, height, kUnityRenderingExtFormatR8G8B8A8_SRGB));
+
+        // The rows may have the padding.
+        const int stride = pitch + 16;
+        std::vector<uint8_t> pixels(static_cast<size_t>(stride) * height, 0xff);
+        SoftwareTextureData data { pixels.data(), pixels.size(), stride };
+        EXPECT_TRUE(device.CopyResourceFromNativeV(dst.get(), &data));
+        EXPECT_EQ(0xff, static_cast<SoftwareTexture2D*>(dst.get())->GetBuffer()[0]);
+
+        // The image which doesn't cover the texture is rejected.
+        SoftwareTextureData narrow { pixels.data(), pixels.size(), pitch - 4 };
+        EXPECT_FALSE(device.CopyResourceFromNativeV(dst.get(), &narrow));
+        SoftwareTextureData small { pixels.data(), static_cast<size_t>(pitch) * (height - 1), pitch };
+        EXPECT_FALSE(device.CopyResourceFromNativeV(dst.get(), &small));
+        SoftwareTextureData empty { nullptr, 0, pitch };
+        EXPECT_FALSE(device.CopyResourceFromNativeV(dst.get(), &empty));
+    }
+
     INSTANTIATE_TEST_SUITE_P(GfxDeviceAndColorSpece, GraphicsDeviceTest, testing::ValuesIn(VALUES_TEST_ENV));
 
 } // end namespace webrtc
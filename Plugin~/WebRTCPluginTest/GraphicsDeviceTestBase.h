@@ -44,7 +44,7 @@ namespace webrtc
 #endif // SUPPORT_D3D12
 #if SUPPORT_METAL
         { kUnityGfxRendererMetal, kUnityRenderingExtFormatB8G8R8A8_SRGB },
-        { kUnityGfxRendererMetal, kUnityRenderingExtFormatB8G8R8A8_UNorm }
+        { kUnityGfxRendererMetal, kUnityRenderingExtFormatB8G8R8A8_UNorm },
 #endif // SUPPORT_METAL
 // todo::(kazuki) windows support
 #if SUPPORT_OPENGL_UNIFIED & UNITY_LINUX
@@ -59,6 +59,8 @@ namespace webrtc
         { kUnityGfxRendererVulkan, kUnityRenderingExtFormatB8G8R8A8_SRGB },
         { kUnityGfxRendererVulkan, kUnityRenderingExtFormatB8G8R8A8_UNorm },
 #endif // SUPPORT_VULKAN
+        { kUnityGfxRendererNull, kUnityRenderingExtFormatB8G8R8A8_SRGB },
+        { kUnityGfxRendererNull, kUnityRenderingExtFormatB8G8R8A8_UNorm },
     };
 
 } // end namespace webrtc
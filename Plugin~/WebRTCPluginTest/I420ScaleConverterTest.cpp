@@ -0,0 +1,168 @@
+#include "pch.h"
+
+#include <chrono>
+
+#include <api/video/i420_buffer.h>
+#include <third_party/libyuv/include/libyuv/convert_from.h>
+#include <third_party/libyuv/include/libyuv/video_common.h>
+
+#include "I420ScaleConverter.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    static constexpr int kBytesPerPixel = 4;
+
+    // The high-frequency noise, which shows any seam between the strips.
+    static rtc::scoped_refptr<I420Buffer> CreateNoiseBuffer(int width, int height)
+    {
+        auto buffer = I420Buffer::Create(width, height);
+        uint32_t seed = 12345;
+        auto fill = [&seed](uint8_t* data, int stride, int w, int h)
+        {
+            for (int y = 0; y < h; y++)
+            {
+                for (int x = 0; x < w; x++)
+                {
+                    seed = seed * 1664525 + 1013904223;
+                    data[y * stride + x] = static_cast<uint8_t>(seed >> 24);
+                }
+            }
+        };
+        fill(buffer->MutableDataY(), buffer->StrideY(), width, height);
+        fill(buffer->MutableDataU(), buffer->StrideU(), buffer->ChromaWidth(), buffer->ChromaHeight());
+        fill(buffer->MutableDataV(), buffer->StrideV(), buffer->ChromaWidth(), buffer->ChromaHeight());
+        return buffer;
+    }
+
+    // The previous path of UnityVideoRenderer, which scales to the temporary I420 frame.
+    static void ScaleAndConvert(const I420BufferInterface& src, std::vector<uint8_t>& dst, int width, int height)
+    {
+        auto scaled = I420Buffer::Create(width, height);
+        scaled->ScaleFrom(src);
+        libyuv::ConvertFromI420(
+            scaled->DataY(),
+            scaled->StrideY(),
+            scaled->DataU(),
+            scaled->StrideU(),
+            scaled->DataV(),
+            scaled->StrideV(),
+            dst.data(),
+            0,
+            width,
+            height,
+            libyuv::FOURCC_ARGB);
+    }
+
+    class I420ScaleConverterTest : public testing::TestWithParam<std::tuple<int, int, int, int>>
+    {
+    protected:
+        I420ScaleConverter converter_;
+    };
+
+    TEST_P(I420ScaleConverterTest, SameAsTwoPass)
+    {
+        int srcWidth, srcHeight, width, height;
+        std::tie(srcWidth, srcHeight, width, height) = GetParam();
+        auto src = CreateNoiseBuffer(srcWidth, srcHeight);
+
+        const size_t size = static_cast<size_t>(width) * height * kBytesPerPixel;
+        std::vector<uint8_t> expected(size);
+        std::vector<uint8_t> actual(size);
+        ScaleAndConvert(*src, expected, width, height);
+        EXPECT_EQ(0, converter_.Convert(*src, actual.data(), 0, width, height, false, libyuv::FOURCC_ARGB));
+
+        EXPECT_EQ(expected, actual);
+    }
+
+    TEST_P(I420ScaleConverterTest, FlipVertical)
+    {
+        int srcWidth, srcHeight, width, height;
+        std::tie(srcWidth, srcHeight, width, height) = GetParam();
+        auto src = CreateNoiseBuffer(srcWidth, srcHeight);
+
+        const size_t stride = static_cast<size_t>(width) * kBytesPerPixel;
+        std::vector<uint8_t> image(stride * height);
+        std::vector<uint8_t> flipped(stride * height);
+        EXPECT_EQ(0, converter_.Convert(*src, image.data(), 0, width, height, false, libyuv::FOURCC_ABGR));
+        EXPECT_EQ(0, converter_.Convert(*src, flipped.data(), 0, width, height, true, libyuv::FOURCC_ABGR));
+        for (int y = 0; y < height; y++)
+        {
+            ASSERT_EQ(0, std::memcmp(image.data() + y * stride, flipped.data() + (height - 1 - y) * stride, stride))
+                << "y:" << y;
+        }
+    }
+
+    TEST_F(I420ScaleConverterTest, SameSize)
+    {
+        const int kWidth = 320;
+        const int kHeight = 241;
+        auto src = CreateNoiseBuffer(kWidth, kHeight);
+
+        const size_t size = static_cast<size_t>(kWidth) * kHeight * kBytesPerPixel;
+        std::vector<uint8_t> expected(size);
+        std::vector<uint8_t> actual(size);
+        ScaleAndConvert(*src, expected, kWidth, kHeight);
+        EXPECT_EQ(0, converter_.Convert(*src, actual.data(), 0, kWidth, kHeight, false, libyuv::FOURCC_ARGB));
+        EXPECT_EQ(expected, actual);
+    }
+
+    // Downscale by the integer ratio in strips, the other ratios, upscale, and the odd sizes.
+    INSTANTIATE_TEST_SUITE_P(
+        Resolutions,
+        I420ScaleConverterTest,
+        testing::Values(
+            std::make_tuple(1920, 1080, 1280, 720),
+            std::make_tuple(1280, 720, 640, 360),
+            std::make_tuple(1920, 1080, 640, 360),
+            std::make_tuple(1280, 720, 320, 180),
+            std::make_tuple(1280, 720, 1000, 360),
+            std::make_tuple(640, 360, 1280, 720),
+            std::make_tuple(321, 241, 200, 150),
+            std::make_tuple(200, 150, 321, 241)));
+
+    // Microbenchmark to compare with the path which scales to the temporary I420 frame.
+    // Run with --gtest_also_run_disabled_tests.
+    class I420ScaleConverterBenchmark : public testing::TestWithParam<std::tuple<int, int, int, int>>
+    {
+    };
+
+    TEST_P(I420ScaleConverterBenchmark, DISABLED_CompareWithTwoPass)
+    {
+        int srcWidth, srcHeight, width, height;
+        std::tie(srcWidth, srcHeight, width, height) = GetParam();
+        auto src = CreateNoiseBuffer(srcWidth, srcHeight);
+        std::vector<uint8_t> image(static_cast<size_t>(width) * height * kBytesPerPixel);
+        I420ScaleConverter converter;
+        const int kIterations = 100;
+
+        auto measure = [&](std::function<void()> func)
+        {
+            func();
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < kIterations; i++)
+                func();
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            return std::chrono::duration<double, std::milli>(elapsed).count() / kIterations;
+        };
+
+        double twoPass = measure([&]() { ScaleAndConvert(*src, image, width, height); });
+        double fused = measure(
+            [&]() { converter.Convert(*src, image.data(), 0, width, height, false, libyuv::FOURCC_ARGB); });
+
+        std::printf(
+            "%dx%d -> %dx%d two-pass: %.3f ms, fused: %.3f ms\n", srcWidth, srcHeight, width, height, twoPass, fused);
+    }
+
+    INSTANTIATE_TEST_SUITE_P(
+        Resolutions,
+        I420ScaleConverterBenchmark,
+        testing::Values(
+            std::make_tuple(1920, 1080, 1280, 720),
+            std::make_tuple(1280, 720, 1920, 1080),
+            std::make_tuple(3840, 2160, 1920, 1080),
+            std::make_tuple(1280, 720, 640, 360)));
+
+} // end namespace webrtc
+} // end namespace unity
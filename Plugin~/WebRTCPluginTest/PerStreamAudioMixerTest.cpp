@@ -0,0 +1,112 @@
+#include "pch.h"
+
+#include <chrono>
+
+#include <modules/audio_mixer/audio_mixer_impl.h>
+
+#include "PerStreamAudioMixer.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    // The receive stream which counts the pulls like the sink of the track.
+    class FakeAudioSource : public AudioMixer::Source
+    {
+    public:
+        FakeAudioSource(int sampleRate, size_t channels, int ssrc)
+            : sampleRate_(sampleRate)
+            , channels_(channels)
+            , ssrc_(ssrc)
+            , samples_(static_cast<size_t>(sampleRate / 100) * channels)
+        {
+            for (size_t i = 0; i < samples_.size(); i++)
+                samples_[i] = static_cast<int16_t>((i * 97 + ssrc * 13) % 2000 - 1000);
+        }
+
+        AudioFrameInfo GetAudioFrameWithInfo(int sample_rate_hz, AudioFrame* audio_frame) override
+        {
+            pullCount++;
+            lastSampleRate = sample_rate_hz;
+            audio_frame->UpdateFrame(
+                0,
+                samples_.data(),
+                static_cast<size_t>(sampleRate_ / 100),
+                sampleRate_,
+                AudioFrame::kNormalSpeech,
+                AudioFrame::kVadActive,
+                channels_);
+            return AudioFrameInfo::kNormal;
+        }
+        int Ssrc() const override { return ssrc_; }
+        int PreferredSampleRate() const override { return sampleRate_; }
+
+        int pullCount = 0;
+        int lastSampleRate = 0;
+
+    private:
+        const int sampleRate_;
+        const size_t channels_;
+        const int ssrc_;
+        std::vector<int16_t> samples_;
+    };
+
+    TEST(PerStreamAudioMixerTest, PullEachStream)
+    {
+        auto mixer = PerStreamAudioMixer::Create();
+        FakeAudioSource source1(48000, 2, 1);
+        FakeAudioSource source2(16000, 1, 2);
+        EXPECT_TRUE(mixer->AddSource(&source1));
+        EXPECT_TRUE(mixer->AddSource(&source2));
+        EXPECT_FALSE(mixer->AddSource(&source1));
+
+        AudioFrame frame;
+        mixer->Mix(2, &frame);
+        EXPECT_EQ(1, source1.pullCount);
+        EXPECT_EQ(1, source2.pullCount);
+
+        // Each stream is pulled at its own sample rate, and the mixed frame is silent.
+        EXPECT_EQ(48000, source1.lastSampleRate);
+        EXPECT_EQ(16000, source2.lastSampleRate);
+        EXPECT_TRUE(frame.muted());
+        EXPECT_EQ(2u, frame.num_channels());
+        EXPECT_EQ(480u, frame.samples_per_channel());
+
+        mixer->RemoveSource(&source2);
+        mixer->Mix(2, &frame);
+        EXPECT_EQ(2, source1.pullCount);
+        EXPECT_EQ(1, source2.pullCount);
+    }
+
+    // Compares with the default mixer of WebRTC.
+    TEST(PerStreamAudioMixerTest, DISABLED_CompareWithAudioMixerImpl)
+    {
+        const int kTrackCount = 32;
+        const int kIterations = 1000;
+        std::vector<std::unique_ptr<FakeAudioSource>> sources;
+        for (int i = 0; i < kTrackCount; i++)
+            sources.push_back(std::make_unique<FakeAudioSource>(48000, 2, i + 1));
+
+        auto measure = [&](rtc::scoped_refptr<AudioMixer> mixer)
+        {
+            for (auto& source : sources)
+                mixer->AddSource(source.get());
+            AudioFrame frame;
+            mixer->Mix(2, &frame);
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < kIterations; i++)
+                mixer->Mix(2, &frame);
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            for (auto& source : sources)
+                mixer->RemoveSource(source.get());
+            return std::chrono::duration<double, std::micro>(elapsed).count() / kIterations;
+        };
+
+        double mix = measure(AudioMixerImpl::Create());
+        double perStream = measure(PerStreamAudioMixer::Create());
+        std::printf("%d tracks, 10 ms each: AudioMixerImpl: %.2f us, PerStreamAudioMixer: %.2f us\n",
+            kTrackCount, mix, perStream);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,210 @@
+#include "pch.h"
+
+#include <chrono>
+#include <random>
+
+#include <third_party/libyuv/include/libyuv/convert.h>
+#include <third_party/libyuv/include/libyuv/convert_from_argb.h>
+
+#include "GraphicsDevice/RGBToI420Converter.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    static std::vector<uint8_t> CreateRandomImage(int width, int height)
+    {
+        std::vector<uint8_t> image(static_cast<size_t>(width) * height * 4);
+        std::mt19937 engine(0);
+        std::uniform_int_distribution<int> dist(0, 255);
+        for (auto& value : image)
+            value = static_cast<uint8_t>(dist(engine));
+        return image;
+    }
+
+    class RGBToI420ConverterTest : public testing::TestWithParam<std::tuple<int, int>>
+    {
+    public:
+        RGBToI420ConverterTest()
+            : pool_(3)
+            , converter_(&pool_)
+        {
+        }
+
+    protected:
+        WorkerThreadPool pool_;
+        RGBToI420Converter converter_;
+    };
+
+    TEST_P(RGBToI420ConverterTest, SameAsSingleThread)
+    {
+        int width, height;
+        std::tie(width, height) = GetParam();
+        std::vector<uint8_t> image = CreateRandomImage(width, height);
+
+        auto expected = webrtc::I420Buffer::Create(width, height);
+        EXPECT_EQ(
+            0,
+            libyuv::ABGRToI420(
+                image.data(),
+                width * 4,
+                expected->MutableDataY(),
+                expected->StrideY(),
+                expected->MutableDataU(),
+                expected->StrideU(),
+                expected->MutableDataV(),
+                expected->StrideV(),
+                width,
+                height));
+
+        auto actual = converter_.Convert(libyuv::ABGRToI420, image.data(), width * 4, width, height);
+        ASSERT_NE(actual, nullptr);
+        EXPECT_EQ(width, actual->width());
+        EXPECT_EQ(height, actual->height());
+
+        const int chromaHeight = (height + 1) / 2;
+        for (int y = 0; y < height; y++)
+        {
+            ASSERT_EQ(
+                0, std::memcmp(expected->DataY() + y * expected->StrideY(), actual->DataY() + y * actual->StrideY(), width))
+                << "y:" << y;
+        }
+        for (int y = 0; y < chromaHeight; y++)
+        {
+            ASSERT_EQ(
+                0,
+                std::memcmp(
+                    expected->DataU() + y * expected->StrideU(), actual->DataU() + y * actual->StrideU(), expected->ChromaWidth()))
+                << "y:" << y;
+            ASSERT_EQ(
+                0,
+                std::memcmp(
+                    expected->DataV() + y * expected->StrideV(), actual->DataV() + y * actual->StrideV(), expected->ChromaWidth()))
+                << "y:" << y;
+        }
+    }
+
+    TEST_P(RGBToI420ConverterTest, SameAsSingleThreadNV12)
+    {
+        int width, height;
+        std::tie(width, height) = GetParam();
+        std::vector<uint8_t> image = CreateRandomImage(width, height);
+
+        auto expected = webrtc::NV12Buffer::Create(width, height);
+        EXPECT_EQ(
+            0,
+            libyuv::ABGRToNV12(
+                image.data(),
+                width * 4,
+                expected->MutableDataY(),
+                expected->StrideY(),
+                expected->MutableDataUV(),
+                expected->StrideUV(),
+                width,
+                height));
+
+        auto actual = converter_.ConvertToNV12(libyuv::ABGRToNV12, image.data(), width * 4, width, height);
+        ASSERT_NE(actual, nullptr);
+        EXPECT_EQ(width, actual->width());
+        EXPECT_EQ(height, actual->height());
+
+        const int chromaHeight = (height + 1) / 2;
+        for (int y = 0; y < height; y++)
+        {
+            ASSERT_EQ(
+                0, std::memcmp(expected->DataY() + y * expected->StrideY(), actual->DataY() + y * actual->StrideY(), width))
+                << "y:" << y;
+        }
+        for (int y = 0; y < chromaHeight; y++)
+        {
+            ASSERT_EQ(
+                0,
+                std::memcmp(
+                    expected->DataUV() + y * expected->StrideUV(),
+                    actual->DataUV() + y * actual->StrideUV(),
+                    expected->ChromaWidth() * 2))
+                << "y:" << y;
+        }
+    }
+
+    // The height which is not multiple of the stripe count, and the odd height.
+    INSTANTIATE_TEST_SUITE_P(
+        Resolutions,
+        RGBToI420ConverterTest,
+        testing::Values(
+            std::make_tuple(64, 64), std::make_tuple(320, 241), std::make_tuple(1280, 720), std::make_tuple(1921, 1081)));
+
+    // Microbenchmark to compare with the single-threaded libyuv.
+    // Run with --gtest_also_run_disabled_tests.
+    class RGBToI420ConverterBenchmark : public testing::TestWithParam<std::tuple<int, int>>
+    {
+    };
+
+    TEST_P(RGBToI420ConverterBenchmark, DISABLED_CompareWithSingleThread)
+    {
+        int width, height;
+        std::tie(width, height) = GetParam();
+        std::vector<uint8_t> image = CreateRandomImage(width, height);
+        auto buffer = webrtc::I420Buffer::Create(width, height);
+        WorkerThreadPool pool(WorkerThreadPool::DefaultThreadCount());
+        RGBToI420Converter converter(&pool);
+        const int kIterations = 100;
+
+        auto measure = [&](std::function<void()> func)
+        {
+            func();
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < kIterations; i++)
+                func();
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            return std::chrono::duration<double, std::milli>(elapsed).count() / kIterations;
+        };
+
+        double single = measure(
+            [&]()
+            {
+                libyuv::ABGRToI420(
+                    image.data(),
+                    width * 4,
+                    buffer->MutableDataY(),
+                    buffer->StrideY(),
+                    buffer->MutableDataU(),
+                    buffer->StrideU(),
+                    buffer->MutableDataV(),
+                    buffer->StrideV(),
+                    width,
+                    height);
+            });
+        double parallel = measure(
+            [&]()
+            {
+                converter.Convert(
+                    libyuv::ABGRToI420,
+                    image.data(),
+                    width * 4,
+                    buffer->MutableDataY(),
+                    buffer->StrideY(),
+                    buffer->MutableDataU(),
+                    buffer->StrideU(),
+                    buffer->MutableDataV(),
+                    buffer->StrideV(),
+                    width,
+                    height);
+            });
+
+        std::printf(
+            "%dx%d single: %.3f ms, parallel(%zu workers): %.3f ms\n",
+            width,
+            height,
+            single,
+            pool.numThreads(),
+            parallel);
+    }
+
+    INSTANTIATE_TEST_SUITE_P(
+        Resolutions,
+        RGBToI420ConverterBenchmark,
+        testing::Values(std::make_tuple(1280, 720), std::make_tuple(1920, 1080), std::make_tuple(3840, 2160)));
+
+} // end namespace webrtc
+} // end namespace unity
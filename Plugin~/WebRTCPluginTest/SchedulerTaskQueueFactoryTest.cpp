@@ -0,0 +1,106 @@
+#include "pch.h"
+
+#include <atomic>
+#include <thread>
+
+#include <rtc_base/event.h>
+#include <rtc_base/time_utils.h>
+
+#include "SchedulerTaskQueueFactory.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    constexpr TimeDelta kTimeout = TimeDelta::Millis(1000);
+
+    class SchedulerTaskQueueFactoryTest : public ::testing::Test
+    {
+    protected:
+        std::unique_ptr<TaskQueueBase, TaskQueueDeleter> CreateTaskQueue()
+        {
+            return factory_.CreateTaskQueue("test", TaskQueueFactory::Priority::NORMAL);
+        }
+
+        SchedulerTaskQueueFactory factory_ { 2 };
+    };
+
+    TEST_F(SchedulerTaskQueueFactoryTest, PostTask)
+    {
+        auto queue = CreateTaskQueue();
+        rtc::Event done;
+        queue->PostTask(
+            [&]()
+            {
+                EXPECT_TRUE(queue->IsCurrent());
+                done.Set();
+            });
+        EXPECT_TRUE(done.Wait(kTimeout));
+    }
+
+    TEST_F(SchedulerTaskQueueFactoryTest, PostDelayedTask)
+    {
+        auto queue = CreateTaskQueue();
+        rtc::Event done;
+        const TimeDelta kDelay = TimeDelta::Millis(20);
+        const int64_t start = rtc::TimeMicros();
+        int64_t elapsed = 0;
+        queue->PostDelayedTask(
+            [&]()
+            {
+                elapsed = rtc::TimeMicros() - start;
+                done.Set();
+            },
+            kDelay);
+        EXPECT_TRUE(done.Wait(kTimeout));
+        EXPECT_GE(elapsed, kDelay.us());
+    }
+
+    TEST_F(SchedulerTaskQueueFactoryTest, RunTasksInOrderOnManyQueues)
+    {
+        // More task queues than the worker threads.
+        const int kQueueCount = 32;
+        const int kTaskCount = 20;
+        std::vector<std::unique_ptr<TaskQueueBase, TaskQueueDeleter>> queues;
+        std::vector<int> lastTask(kQueueCount, -1);
+        std::vector<std::atomic<int>> running(kQueueCount);
+        std::atomic<int> remaining(kQueueCount * kTaskCount);
+        std::atomic<bool> failed(false);
+        rtc::Event done;
+
+        for (int i = 0; i < kQueueCount; i++)
+            queues.push_back(CreateTaskQueue());
+        for (int task = 0; task < kTaskCount; task++)
+        {
+            for (int i = 0; i < kQueueCount; i++)
+            {
+                queues[i]->PostDelayedTask(
+                    [&, i, task]()
+                    {
+                        // The tasks of the same queue never run concurrently or out of order.
+                        if (running[i]++ != 0 || lastTask[i] >= task)
+                            failed = true;
+                        lastTask[i] = task;
+                        running[i]--;
+                        if (--remaining == 0)
+                            done.Set();
+                    },
+                    TimeDelta::Millis(task));
+            }
+        }
+        EXPECT_TRUE(done.Wait(kTimeout));
+        EXPECT_FALSE(failed);
+    }
+
+    TEST_F(SchedulerTaskQueueFactoryTest, DeleteWithPendingTask)
+    {
+        auto queue = CreateTaskQueue();
+        std::atomic<bool> ran(false);
+        queue->PostDelayedTask([&]() { ran = true; }, TimeDelta::Millis(10));
+        queue = nullptr;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_FALSE(ran);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,93 @@
+#include "pch.h"
+
+#include <api/video/i420_buffer.h>
+
+#include "StaticContentDetector.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    using UpdateRect = ::webrtc::VideoFrame::UpdateRect;
+
+    class StaticContentDetectorTest : public ::testing::Test
+    {
+    protected:
+        rtc::scoped_refptr<I420Buffer> CreateBuffer(int width, int height)
+        {
+            auto buffer = I420Buffer::Create(width, height);
+            I420Buffer::SetBlack(buffer.get());
+            return buffer;
+        }
+
+        StaticContentDetector detector_;
+    };
+
+    TEST_F(StaticContentDetectorTest, FirstFrameIsFullUpdate)
+    {
+        auto buffer = CreateBuffer(320, 240);
+        UpdateRect rect = detector_.Detect(*buffer);
+        EXPECT_EQ(0, rect.offset_x);
+        EXPECT_EQ(0, rect.offset_y);
+        EXPECT_EQ(320, rect.width);
+        EXPECT_EQ(240, rect.height);
+    }
+
+    TEST_F(StaticContentDetectorTest, IdenticalFrameIsEmpty)
+    {
+        auto buffer = CreateBuffer(320, 240);
+        detector_.Detect(*buffer);
+
+        // The other buffer which has the same pixels.
+        auto copy = I420Buffer::Copy(*buffer);
+        EXPECT_TRUE(detector_.Detect(*copy).IsEmpty());
+    }
+
+    TEST_F(StaticContentDetectorTest, ChangedTiles)
+    {
+        const int kTileSize = StaticContentDetector::kTileSize;
+        auto buffer = CreateBuffer(320, 240);
+        detector_.Detect(*buffer);
+
+        // Changes the pixels in the second tile of the first row and the last tile.
+        buffer->MutableDataY()[kTileSize + 1] = 255;
+        buffer->MutableDataY()[239 * buffer->StrideY() + 319] = 255;
+        UpdateRect rect = detector_.Detect(*buffer);
+        EXPECT_EQ(kTileSize, rect.offset_x);
+        EXPECT_EQ(0, rect.offset_y);
+        EXPECT_EQ(320 - kTileSize, rect.width);
+        EXPECT_EQ(240, rect.height);
+
+        EXPECT_TRUE(detector_.Detect(*buffer).IsEmpty());
+    }
+
+    TEST_F(StaticContentDetectorTest, ChangedColor)
+    {
+        const int kTileSize = StaticContentDetector::kTileSize;
+        auto buffer = CreateBuffer(320, 240);
+        detector_.Detect(*buffer);
+
+        // Only the chroma of the tile at (2, 1) is changed.
+        buffer->MutableDataV()[(kTileSize / 2) * buffer->StrideV() + kTileSize] = 0;
+        UpdateRect rect = detector_.Detect(*buffer);
+        EXPECT_EQ(kTileSize * 2, rect.offset_x);
+        EXPECT_EQ(kTileSize, rect.offset_y);
+        EXPECT_EQ(kTileSize, rect.width);
+        EXPECT_EQ(kTileSize, rect.height);
+    }
+
+    TEST_F(StaticContentDetectorTest, ResizeIsFullUpdate)
+    {
+        detector_.Detect(*CreateBuffer(320, 240));
+        UpdateRect rect = detector_.Detect(*CreateBuffer(640, 480));
+        EXPECT_EQ(640, rect.width);
+        EXPECT_EQ(480, rect.height);
+
+        detector_.Reset();
+        rect = detector_.Detect(*CreateBuffer(640, 480));
+        EXPECT_EQ(640, rect.width);
+        EXPECT_EQ(480, rect.height);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
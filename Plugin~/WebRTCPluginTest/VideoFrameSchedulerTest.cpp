@@ -85,6 +85,13 @@ namespace webrtc
 
         void CaptureCallback() { count_++; }
 
+        // Notifies the scheduler of the frame from the render thread.
+        void SendFrame()
+        {
+            auto frame = VideoFrame::WrapExternalGpuMemoryBuffer(Size(1280, 720), nullptr, nullptr, TimeDelta::Zero());
+            scheduler_->OnFrameCaptured(frame.get());
+        }
+
     protected:
         const int kMaxFramerate = 30;
         const TimeDelta kTimeDelta = TimeDelta::Seconds(1) / kMaxFramerate;
@@ -98,6 +105,7 @@ namespace webrtc
         FakeTaskQueue queue(&clock_);
         InitScheduler(queue);
         EXPECT_EQ(0, count_);
+        SendFrame();
         EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
         EXPECT_EQ(1, count_);
 
@@ -115,6 +123,7 @@ namespace webrtc
         EXPECT_EQ(0, count_);
 
         scheduler_->Pause(false);
+        SendFrame();
         EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
         EXPECT_EQ(1, count_);
 
@@ -130,14 +139,115 @@ namespace webrtc
         const int maxFramerate = 5;
         scheduler_->SetMaxFramerateFps(maxFramerate);
         EXPECT_GT(queue.last_delay(), TimeDelta::Zero());
+        SendFrame();
         EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
         EXPECT_EQ(1, count_);
 
         EXPECT_GT(queue.last_delay(), TimeDelta::Zero());
+        SendFrame();
         EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
         EXPECT_EQ(2, count_);
 
         scheduler_ = nullptr;
     }
+
+    TEST_F(VideoFrameSchedulerTest, SkipTickWithoutFreshFrame)
+    {
+        FakeTaskQueue queue(&clock_);
+        InitScheduler(queue);
+
+        SendFrame();
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(1, count_);
+        EXPECT_GT(queue.last_delay(), TimeDelta::Zero());
+
+        // The same frame is not captured again. Without the estimate of the arrival
+        // the tick must not be posted again at once.
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(1, count_);
+        EXPECT_GT(queue.last_delay(), TimeDelta::Zero());
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(1, count_);
+        EXPECT_GT(queue.last_delay(), TimeDelta::Zero());
+
+        // Only the latest one of the frames which arrived between the ticks is captured.
+        SendFrame();
+        SendFrame();
+        SendFrame();
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(2, count_);
+        EXPECT_GT(queue.last_delay(), TimeDelta::Zero());
+
+        VideoFrameSchedulerStats stats = scheduler_->GetStats();
+        EXPECT_EQ(2u, stats.capturedFrames);
+        EXPECT_EQ(2u, stats.duplicateTicks);
+        EXPECT_EQ(2u, stats.missedFrames);
+
+        scheduler_ = nullptr;
+    }
+
+    TEST_F(VideoFrameSchedulerTest, BackOffWhenSourceStops)
+    {
+        FakeTaskQueue queue(&clock_);
+        scheduler_ = std::make_unique<VideoFrameScheduler>(&queue, &clock_);
+        scheduler_->SetMaxFramerateFps(kMaxFramerate);
+
+        const TimeDelta kArrivalInterval = TimeDelta::Millis(40);
+        for (int i = 0; i < 10; i++)
+        {
+            SendFrame();
+            clock_.AdvanceTime(kArrivalInterval);
+        }
+        SendFrame();
+        scheduler_->Start(std::bind(&VideoFrameSchedulerTest::CaptureCallback, this));
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(1, count_);
+
+        // The late frame is retried a few times in the interval of the arrival.
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(kArrivalInterval / 4, queue.last_delay());
+
+        // The source has stopped, so the tick falls back to the interval of the max framerate.
+        for (int i = 0; i < 20; i++)
+            EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(1, count_);
+        EXPECT_EQ(kTimeDelta, queue.last_delay());
+
+        // The retry resumes when the source sends the frame again.
+        SendFrame();
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(2, count_);
+
+        scheduler_ = nullptr;
+    }
+
+    TEST_F(VideoFrameSchedulerTest, AlignToFrameArrival)
+    {
+        FakeTaskQueue queue(&clock_);
+        scheduler_ = std::make_unique<VideoFrameScheduler>(&queue, &clock_);
+        scheduler_->SetMaxFramerateFps(kMaxFramerate);
+
+        // The frames arrive slower than the max framerate.
+        const TimeDelta kArrivalInterval = TimeDelta::Millis(50);
+        for (int i = 0; i < 10; i++)
+        {
+            SendFrame();
+            clock_.AdvanceTime(kArrivalInterval);
+        }
+        SendFrame();
+        scheduler_->Start(std::bind(&VideoFrameSchedulerTest::CaptureCallback, this));
+
+        // The tick waits for the next frame instead of the interval of the max framerate.
+        EXPECT_GT(queue.last_delay(), kTimeDelta);
+        EXPECT_LE(queue.last_delay(), kArrivalInterval + TimeDelta::Millis(1));
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(1, count_);
+
+        VideoFrameSchedulerStats stats = scheduler_->GetStats();
+        EXPECT_EQ(0, stats.arrivalJitterUs);
+        EXPECT_EQ(10u, stats.missedFrames);
+
+        scheduler_ = nullptr;
+    }
 }
 }
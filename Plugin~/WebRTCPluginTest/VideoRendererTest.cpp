@@ -1,5 +1,8 @@
 #include "pch.h"
 
+#include <atomic>
+#include <thread>
+
 #include "Context.h"
 #include "GraphicsDevice/IGraphicsDevice.h"
 #include "GraphicsDevice/ITexture2D.h"
@@ -19,6 +22,34 @@ namespace webrtc
     const int kWidth = 256;
     const int kHeight = 256;
 
+    // The native buffer which counts the conversions.
+    class FakeNativeBuffer : public VideoFrameBuffer
+    {
+    public:
+        FakeNativeBuffer(int width, int height, int* convertCount)
+            : width_(width)
+            , height_(height)
+            , convertCount_(convertCount)
+        {
+        }
+
+        Type type() const override { return Type::kNative; }
+        int width() const override { return width_; }
+        int height() const override { return height_; }
+        rtc::scoped_refptr<I420BufferInterface> ToI420() override
+        {
+            (*convertCount_)++;
+            rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width_, height_);
+            I420Buffer::SetBlack(buffer.get());
+            return buffer;
+        }
+
+    private:
+        const int width_;
+        const int height_;
+        int* const convertCount_;
+    };
+
     class VideoRendererTest : public GraphicsDeviceTestBase
     {
     public:
@@ -69,6 +100,125 @@ namespace webrtc
         EXPECT_NE(nullptr, m_renderer->GetFrameBuffer());
     }
 
+    TEST_P(VideoRendererTest, GetLatestFrameBuffer)
+    {
+        auto first = webrtc::I420Buffer::Create(kWidth, kHeight);
+        auto second = webrtc::I420Buffer::Create(kWidth, kHeight);
+        m_renderer->SetFrameBuffer(first, 1);
+        m_renderer->SetFrameBuffer(second, 2);
+
+        // The frame which is not taken is replaced.
+        EXPECT_EQ(second, m_renderer->GetFrameBuffer());
+        EXPECT_EQ(nullptr, m_renderer->GetFrameBuffer());
+        EXPECT_EQ(1u, m_renderer->droppedFrameCount());
+
+        m_renderer->SetFrameBuffer(first, 3);
+        EXPECT_EQ(first, m_renderer->GetFrameBuffer());
+        EXPECT_EQ(1u, m_renderer->droppedFrameCount());
+    }
+
+    TEST_P(VideoRendererTest, PresentDueFrame)
+    {
+        const int64_t kIntervalUs = 10000;
+        auto first = webrtc::I420Buffer::Create(kWidth, kHeight);
+        auto second = webrtc::I420Buffer::Create(kWidth, kHeight);
+        auto third = webrtc::I420Buffer::Create(kWidth, kHeight);
+
+        // The burst of the decoded frames.
+        m_renderer->SetFrameBuffer(first, kIntervalUs);
+        m_renderer->SetFrameBuffer(second, kIntervalUs * 2);
+        m_renderer->SetFrameBuffer(third, kIntervalUs * 3);
+
+        // No frame is due yet. Each frame of the burst waits for its render time.
+        EXPECT_EQ(nullptr, m_renderer->GetFrameBuffer(0));
+        EXPECT_EQ(first, m_renderer->GetFrameBuffer(kIntervalUs));
+        EXPECT_EQ(second, m_renderer->GetFrameBuffer(kIntervalUs * 2));
+
+        // The update is delayed, the late frame is still presented.
+        EXPECT_EQ(third, m_renderer->GetFrameBuffer(kIntervalUs * 5));
+        EXPECT_EQ(nullptr, m_renderer->GetFrameBuffer(kIntervalUs * 6));
+
+        VideoRendererStats stats = m_renderer->GetStats();
+        EXPECT_EQ(3u, stats.presentedFrames);
+        EXPECT_EQ(3u, stats.earlyFrames);
+        EXPECT_EQ(1u, stats.lateFrames);
+        EXPECT_EQ(0u, stats.droppedFrames);
+    }
+
+    TEST_P(VideoRendererTest, DropFramesOverQueueSize)
+    {
+        const uint32_t kFrameCount = UnityVideoRenderer::kQueueSize + 2;
+        std::vector<rtc::scoped_refptr<webrtc::I420Buffer>> buffers;
+        for (uint32_t i = 0; i < kFrameCount; i++)
+        {
+            buffers.push_back(webrtc::I420Buffer::Create(kWidth, kHeight));
+            m_renderer->SetFrameBuffer(buffers.back(), i);
+        }
+        // The two oldest frames are dropped to queue the newest ones.
+        EXPECT_EQ(2u, m_renderer->droppedFrameCount());
+
+        EXPECT_EQ(buffers.back(), m_renderer->GetFrameBuffer(kFrameCount));
+        EXPECT_EQ(static_cast<uint64_t>(kFrameCount - 1), m_renderer->droppedFrameCount());
+    }
+
+    TEST_P(VideoRendererTest, KeepNewestFrameWhenQueueIsFull)
+    {
+        const int64_t kIntervalUs = 10000;
+        const uint32_t kFrameCount = UnityVideoRenderer::kQueueSize + 1;
+        std::vector<rtc::scoped_refptr<webrtc::I420Buffer>> buffers;
+        for (uint32_t i = 0; i < kFrameCount; i++)
+        {
+            buffers.push_back(webrtc::I420Buffer::Create(kWidth, kHeight));
+            m_renderer->SetFrameBuffer(buffers.back(), kIntervalUs * (i + 1));
+        }
+
+        // The first frame was dropped, the second one is the oldest in the queue.
+        EXPECT_EQ(nullptr, m_renderer->GetFrameBuffer(kIntervalUs));
+        EXPECT_EQ(buffers[1], m_renderer->GetFrameBuffer(kIntervalUs * 2));
+        EXPECT_EQ(buffers.back(), m_renderer->GetFrameBuffer(kIntervalUs * kFrameCount));
+        EXPECT_EQ(static_cast<uint64_t>(kFrameCount - 2), m_renderer->droppedFrameCount());
+    }
+
+    TEST_P(VideoRendererTest, SetAndGetFrameBufferOnTwoThreads)
+    {
+        const int kFrameCount = 10000;
+        std::vector<rtc::scoped_refptr<webrtc::I420Buffer>> buffers;
+        for (int i = 0; i < kFrameCount; i++)
+            buffers.push_back(webrtc::I420Buffer::Create(2, 2));
+
+        std::atomic<bool> done(false);
+        std::thread decoder(
+            [&]()
+            {
+                for (const auto& buffer : buffers)
+                    m_renderer->SetFrameBuffer(buffer, 0);
+                done = true;
+            });
+
+        // The frames are taken in the order of the arrival, and every frame is
+        // either presented or counted as dropped.
+        uint64_t presentedCount = 0;
+        int lastIndex = -1;
+        while (true)
+        {
+            const bool finished = done;
+            auto buffer = m_renderer->GetFrameBuffer(1);
+            if (!buffer)
+            {
+                if (finished)
+                    break;
+                continue;
+            }
+            const int index = static_cast<int>(std::find(buffers.begin(), buffers.end(), buffer) - buffers.begin());
+            EXPECT_GT(index, lastIndex);
+            lastIndex = index;
+            presentedCount++;
+        }
+        decoder.join();
+        EXPECT_EQ(kFrameCount - 1, lastIndex);
+        EXPECT_EQ(static_cast<uint64_t>(kFrameCount), presentedCount + m_renderer->droppedFrameCount());
+    }
+
     TEST_P(VideoRendererTest, ConvertVideoFrameToTexture)
     {
         auto builder = CreateBlackFrameBuilder(kWidth, kHeight);
@@ -78,6 +228,24 @@ namespace webrtc
         EXPECT_NE(nullptr, data);
     }
 
+    TEST_P(VideoRendererTest, ConvertOnlyRenderedNativeFrame)
+    {
+        int convertCount = 0;
+        const int kFrameCount = 3;
+        for (int i = 0; i < kFrameCount; i++)
+        {
+            auto buffer = rtc::make_ref_counted<FakeNativeBuffer>(kWidth, kHeight, &convertCount);
+            m_renderer->OnFrame(
+                ::webrtc::VideoFrame::Builder().set_video_frame_buffer(buffer).set_timestamp_us(i + 1).build());
+        }
+        EXPECT_EQ(0, convertCount);
+
+        void* data = m_renderer->ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB);
+        EXPECT_NE(nullptr, data);
+        EXPECT_EQ(1, convertCount);
+        EXPECT_EQ(static_cast<uint64_t>(kFrameCount - 1), m_renderer->droppedFrameCount());
+    }
+
     INSTANTIATE_TEST_SUITE_P(GfxDeviceAndColorSpece, VideoRendererTest, testing::ValuesIn(VALUES_TEST_ENV));
 
 } // end namespace webrtc
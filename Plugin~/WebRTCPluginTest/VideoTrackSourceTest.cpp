@@ -87,6 +87,21 @@ namespace webrtc
         EXPECT_TRUE(done.Wait(kTimeout));
     }
 
+    TEST_P(VideoTrackSourceTest, OverwriteUnconsumedFrame)
+    {
+        rtc::Event done;
+        EXPECT_CALL(sink_, OnFrame(_))
+            .WillRepeatedly(Invoke([&done](const ::webrtc::VideoFrame& frame) { done.Set(); }));
+
+        // The scheduler consumes at most one frame per tick, so the others are replaced.
+        const int kFrameCount = 10;
+        for (int i = 0; i < kFrameCount; i++)
+            SendTestFrame();
+        EXPECT_TRUE(done.Wait(kTimeout));
+        EXPECT_GE(m_trackSource->overwrittenFrameCount(), 1u);
+        EXPECT_LT(m_trackSource->overwrittenFrameCount(), static_cast<uint64_t>(kFrameCount));
+    }
+
     INSTANTIATE_TEST_SUITE_P(GfxDeviceAndColorSpece, VideoTrackSourceTest, testing::ValuesIn(VALUES_TEST_ENV));
 
 } // end namespace webrtc
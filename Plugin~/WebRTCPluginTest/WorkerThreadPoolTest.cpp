@@ -0,0 +1,48 @@
+#include "pch.h"
+
+#include <atomic>
+#include <thread>
+
+#include "WorkerThreadPool.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    TEST(WorkerThreadPoolTest, RunAllIndices)
+    {
+        WorkerThreadPool pool(3);
+        const int kCount = 100;
+        std::vector<std::atomic<int>> counts(kCount);
+        pool.ParallelFor(kCount, [&](int index) { counts[index]++; });
+        for (int i = 0; i < kCount; i++)
+            EXPECT_EQ(1, counts[i]) << "index:" << i;
+    }
+
+    TEST(WorkerThreadPoolTest, RunOnCallingThreadWithoutWorkers)
+    {
+        WorkerThreadPool pool(0);
+        const std::thread::id caller = std::this_thread::get_id();
+        int count = 0;
+        pool.ParallelFor(
+            4,
+            [&](int index)
+            {
+                EXPECT_EQ(caller, std::this_thread::get_id());
+                count++;
+            });
+        EXPECT_EQ(4, count);
+    }
+
+    TEST(WorkerThreadPoolTest, DestroyWhileIdle)
+    {
+        // The workers are joined by the owner, not by the static destruction.
+        auto pool = std::make_unique<WorkerThreadPool>(WorkerThreadPool::DefaultThreadCount());
+        std::atomic<int> count(0);
+        pool->ParallelFor(8, [&](int index) { count++; });
+        pool.reset();
+        EXPECT_EQ(8, count);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -1,4 +1,5 @@
 using System;
+using System.Runtime.InteropServices;
 using Unity.Collections;
 using Unity.Collections.LowLevel.Unsafe;
 using UnityEngine;
@@ -21,6 +22,65 @@ namespace Unity.WebRTC
         }
     }
 
+    /// <summary>
+    /// The statistics of the playout of the remote audio track.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct AudioPlayoutStats
+    {
+        /// <summary>
+        /// The number of the audio buffers of Unity which were not filled because not enough audio had arrived.
+        /// </summary>
+        public ulong underruns;
+        /// <summary>
+        /// The number of the received audio chunks which were dropped because the playout buffer was full.
+        /// </summary>
+        public ulong overruns;
+        /// <summary>
+        /// The smoothed amount of the buffered audio in milliseconds.
+        /// </summary>
+        public double bufferedMs;
+        /// <summary>
+        /// The estimated drift of the clock of the received audio from the audio clock of Unity in ppm.
+        /// </summary>
+        public double driftPpm;
+    }
+
+    /// <summary>
+    /// The statistics of the 10 ms tick which pulls the received audio from WebRTC.
+    /// The tick is scheduled at the absolute deadlines, so the delay of one tick does not shift the following ticks.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct AudioTickStats
+    {
+        /// <summary>
+        /// The upper bounds of the buckets of <see cref="histogram"/> in microseconds. The last bucket has no bound.
+        /// </summary>
+        public static readonly int[] HistogramBoundsUs = { 250, 500, 1000, 2000, 5000, 10000, 20000 };
+
+        /// <summary>
+        /// The number of the ticks which have run.
+        /// </summary>
+        public ulong ticks;
+        /// <summary>
+        /// The number of the ticks which ran 10 milliseconds or more behind their deadline and were caught up.
+        /// </summary>
+        public ulong lateTicks;
+        /// <summary>
+        /// The number of the ticks which were dropped because the tick fell more than 50 milliseconds behind.
+        /// </summary>
+        public ulong skippedTicks;
+        /// <summary>
+        /// The largest delay of the tick from its deadline in milliseconds.
+        /// </summary>
+        public double maxJitterMs;
+        /// <summary>
+        /// The number of the ticks for each delay from the deadline.
+        /// </summary>
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 8)]
+        public ulong[] histogram;
+    }
+
     /// <summary>
     ///
     /// </summary>
@@ -165,6 +225,71 @@ namespace Unity.WebRTC
             {
                 NativeMethods.AudioTrackSinkProcessAudio(self, data, data.Length, channels, sampleRate);
             }
+
+            internal AudioPlayoutStats PlayoutStats
+            {
+                get
+                {
+                    NativeMethods.AudioTrackSinkGetStats(self, out var stats);
+                    return stats;
+                }
+            }
+
+            private int _targetLatency = DefaultTargetLatency;
+
+            internal int TargetLatency
+            {
+                get
+                {
+                    return _targetLatency;
+                }
+                set
+                {
+                    _targetLatency = value;
+                    NativeMethods.AudioTrackSinkSetTargetLatency(self, value);
+                }
+            }
+        }
+
+        /// <summary>
+        /// The default of <see cref="PlayoutTargetLatency"/>.
+        /// </summary>
+        public const int DefaultTargetLatency = 20;
+
+        /// <summary>
+        /// The amount of the received audio in milliseconds which the playout keeps buffered.
+        /// The audio is stretched slightly to hold this amount while the clocks drift apart.
+        /// Up to 1000 milliseconds.
+        /// </summary>
+        public int PlayoutTargetLatency
+        {
+            get
+            {
+                if (_streamRenderer == null)
+                    throw new InvalidOperationException("This track is not a remote track.");
+                return _streamRenderer.TargetLatency;
+            }
+            set
+            {
+                if (_streamRenderer == null)
+                    throw new InvalidOperationException("This track is not a remote track.");
+                if (value < 0 || value > 1000)
+                    throw new ArgumentOutOfRangeException(nameof(value), value, "The latency must be 0 to 1000 milliseconds.");
+                _streamRenderer.TargetLatency = value;
+            }
+        }
+
+        /// <summary>
+        /// The statistics of the playout of the received audio.
+        /// </summary>
+        public AudioPlayoutStats PlayoutStats
+        {
+            get
+            {
+                if (_streamRenderer == null)
+                    throw new InvalidOperationException("This track is not a remote track.");
+                return _streamRenderer.PlayoutStats;
+            }
         }
 
         readonly AudioCustomFilter _audioCapturer;
@@ -306,14 +431,15 @@ namespace Unity.WebRTC
             }
         }
 
-        static void ProcessAudio(AudioTrackSource source, IntPtr array, int sampleRate, int channels, int frames)
+        static void ProcessAudio(AudioTrackSource source, IntPtr array, int sampleRate, int channels, int length)
         {
-            if (sampleRate == 0 || channels == 0 || frames == 0)
+            if (sampleRate == 0 || channels == 0 || length == 0)
                 throw new ArgumentException($"arguments are invalid values " +
                     $"sampleRate={sampleRate}, " +
                     $"channels={channels}, " +
-                    $"frames={frames}");
-            source.Update(array, sampleRate, channels, frames);
+                    $"length={length}");
+            // The samples are interleaved, the native side counts the frames of all channels.
+            source.Update(array, sampleRate, channels, length / channels);
         }
 
         /// <summary>
@@ -1,4 +1,5 @@
 using System;
+using System.Collections.Generic;
 using System.Threading;
 using UnityEngine;
 
@@ -66,7 +67,11 @@ namespace Unity.WebRTC
         private int renderEventID = -1;
         private IntPtr releaseBuffersFunction;
         private int releaseBuffersEventID = -1;
+        private IntPtr prewarmBuffersFunction;
+        private int prewarmBuffersEventID = -1;
         private IntPtr textureUpdateFunction;
+        private IntPtr batchUpdateTexturesFunction;
+        private int batchUpdateTexturesEventID = -1;
 
         public static Context Create(int id = 0)
         {
@@ -231,6 +236,12 @@ namespace Unity.WebRTC
             NativeMethods.ContextDeleteAudioTrackSink(self, sink);
         }
 
+        public AudioTickStats GetAudioTickStats()
+        {
+            NativeMethods.ContextGetAudioTickStats(self, out var stats);
+            return stats;
+        }
+
         public IntPtr GetRenderEventFunc()
         {
             return NativeMethods.GetRenderEventFunc(self);
@@ -251,11 +262,31 @@ namespace Unity.WebRTC
             return NativeMethods.GetReleaseBuffersEventID();
         }
 
+        public IntPtr GetPrewarmBuffersFunc()
+        {
+            return NativeMethods.GetPrewarmBuffersFunc(self);
+        }
+
+        public int GetPrewarmBuffersEventID()
+        {
+            return NativeMethods.GetPrewarmBuffersEventID();
+        }
+
         public IntPtr GetUpdateTextureFunc()
         {
             return NativeMethods.GetUpdateTextureFunc(self);
         }
 
+        public IntPtr GetBatchUpdateTexturesFunc()
+        {
+            return NativeMethods.GetBatchUpdateTexturesFunc(self);
+        }
+
+        public int GetBatchUpdateTexturesEventID()
+        {
+            return NativeMethods.GetBatchUpdateTexturesEventID();
+        }
+
         public IntPtr CreateVideoTrackSource()
         {
             return NativeMethods.ContextCreateVideoTrackSource(self);
@@ -326,10 +357,26 @@ namespace Unity.WebRTC
             VideoEncoderMethods.ReleaseBuffers(releaseBuffersFunction, releaseBuffersEventID);
         }
 
+        internal void PrewarmBuffers(IntPtr ptr)
+        {
+            prewarmBuffersFunction = prewarmBuffersFunction == IntPtr.Zero ? GetPrewarmBuffersFunc() : prewarmBuffersFunction;
+            prewarmBuffersEventID = prewarmBuffersEventID == -1 ? GetPrewarmBuffersEventID() : prewarmBuffersEventID;
+            VideoEncoderMethods.Encode(prewarmBuffersFunction, prewarmBuffersEventID, ptr);
+        }
+
         internal void UpdateRendererTexture(uint rendererId, UnityEngine.Texture texture)
         {
             textureUpdateFunction = textureUpdateFunction == IntPtr.Zero ? GetUpdateTextureFunc() : textureUpdateFunction;
             VideoDecoderMethods.UpdateRendererTexture(textureUpdateFunction, texture, rendererId);
         }
+
+        internal void UpdateRendererTextures(IReadOnlyList<UnityVideoRenderer> renderers)
+        {
+            textureUpdateFunction = textureUpdateFunction == IntPtr.Zero ? GetUpdateTextureFunc() : textureUpdateFunction;
+            batchUpdateTexturesFunction = batchUpdateTexturesFunction == IntPtr.Zero ? GetBatchUpdateTexturesFunc() : batchUpdateTexturesFunction;
+            batchUpdateTexturesEventID = batchUpdateTexturesEventID == -1 ? GetBatchUpdateTexturesEventID() : batchUpdateTexturesEventID;
+            VideoDecoderMethods.UpdateRendererTextures(
+                batchUpdateTexturesFunction, batchUpdateTexturesEventID, textureUpdateFunction, renderers);
+        }
     }
 }
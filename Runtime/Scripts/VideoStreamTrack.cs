@@ -1,7 +1,10 @@
 using System;
 using System.Collections.Concurrent;
+using System.Collections.Generic;
 using System.ComponentModel;
 using System.Runtime.InteropServices;
+using System.Threading;
+using Unity.Collections.LowLevel.Unsafe;
 using UnityEngine;
 using UnityEngine.Experimental.Rendering;
 
@@ -13,6 +16,58 @@ namespace Unity.WebRTC
     /// <param name="renderer"></param>
     public delegate void OnVideoReceived(Texture renderer);
 
+    /// <summary>
+    /// The statistics of the pacing of the frame capture of the local video track.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct VideoCaptureStats
+    {
+        /// <summary>
+        /// The number of the captured frames.
+        /// </summary>
+        public ulong capturedFrames;
+        /// <summary>
+        /// The number of the capture ticks skipped because no new frame had arrived.
+        /// </summary>
+        public ulong duplicateTicks;
+        /// <summary>
+        /// The number of the frames replaced by the next frame before the capture.
+        /// </summary>
+        public ulong missedFrames;
+        /// <summary>
+        /// The smoothed jitter of the arrival of the frames in microseconds.
+        /// </summary>
+        public long arrivalJitterUs;
+        /// <summary>
+        /// The smoothed delay from the arrival of the frame to the capture in microseconds.
+        /// </summary>
+        public long captureDelayUs;
+    }
+
+    /// <summary>
+    /// The statistics of the presentation of the frames of the remote video track.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct VideoRenderStats
+    {
+        /// <summary>
+        /// The number of the frames rendered to the texture.
+        /// </summary>
+        public ulong presentedFrames;
+        /// <summary>
+        /// The number of the frames held back at least one frame because their render time had not come.
+        /// </summary>
+        public ulong earlyFrames;
+        /// <summary>
+        /// The number of the frames rendered later than one frame after their render time.
+        /// </summary>
+        public ulong lateFrames;
+        /// <summary>
+        /// The number of the frames never rendered to the texture.
+        /// </summary>
+        public ulong droppedFrames;
+    }
+
     /// <summary>
     ///
     /// </summary>
@@ -55,6 +110,12 @@ namespace Unity.WebRTC
             m_renderer?.Update();
         }
 
+        internal void CollectReceiveRenderer(List<UnityVideoRenderer> renderers)
+        {
+            if (m_renderer?.Texture != null)
+                renderers.Add(m_renderer);
+        }
+
         internal void UpdateSendTexture()
         {
             m_source?.Update();
@@ -72,6 +133,16 @@ namespace Unity.WebRTC
             if (!s_tracks.TryAdd(self, new WeakReference<VideoStreamTrack>(this)))
                 throw new InvalidOperationException();
 
+            // Without graphics device, the pixels of the texture are read from CPU memory.
+            if (SystemInfo.graphicsDeviceType == UnityEngine.Rendering.GraphicsDeviceType.Null)
+            {
+                var texture2D = texture as Texture2D;
+                if (texture2D == null || !texture2D.isReadable)
+                    throw new ArgumentException("The texture must be readable Texture2D without graphics device.");
+                if (GraphicsFormatUtility.GetBlockSize(texture2D.graphicsFormat) != 4)
+                    throw new ArgumentException("The texture must have 32bit per pixel without graphics device.");
+            }
+
             var dest = CreateRenderTexture(texture.width, texture.height);
 
             m_source = source;
@@ -113,6 +184,102 @@ namespace Unity.WebRTC
             base.Dispose();
         }
 
+        /// <summary>
+        /// Sets the limits of the buffer pool used for encoding this track.
+        /// When the pool holds <paramref name="maxBufferCount"/> buffers, new frames are dropped.
+        /// Buffers which are not used during <paramref name="staleFrameLimit"/> are released.
+        /// </summary>
+        /// <param name="maxBufferCount"></param>
+        /// <param name="staleFrameLimit"></param>
+        public void SetBufferPoolLimits(int maxBufferCount, TimeSpan staleFrameLimit)
+        {
+            if (m_source == null)
+                throw new InvalidOperationException("This track is not a local track.");
+            if (maxBufferCount <= 0)
+                throw new ArgumentOutOfRangeException(nameof(maxBufferCount));
+            if (staleFrameLimit <= TimeSpan.Zero)
+                throw new ArgumentOutOfRangeException(nameof(staleFrameLimit));
+            m_source.SetBufferPoolLimits(maxBufferCount, staleFrameLimit);
+        }
+
+        /// <summary>
+        /// Allocates buffers for encoding before streaming to avoid the hitch on the first frames.
+        /// </summary>
+        /// <param name="count"></param>
+        public void PrewarmBuffers(int count)
+        {
+            if (m_source == null)
+                throw new InvalidOperationException("This track is not a local track.");
+            if (count < 0)
+                throw new ArgumentOutOfRangeException(nameof(count));
+            m_source.PrewarmBuffers(count);
+        }
+
+        /// <summary>
+        /// The number of captured frames which were replaced by the next frame before being encoded.
+        /// </summary>
+        public ulong OverwrittenFrameCount
+        {
+            get
+            {
+                if (m_source == null)
+                    throw new InvalidOperationException("This track is not a local track.");
+                return m_source.OverwrittenFrameCount;
+            }
+        }
+
+        /// <summary>
+        /// The number of screencast frames which were not sent because nothing changed from the previous frame.
+        /// </summary>
+        public ulong StaticFrameCount
+        {
+            get
+            {
+                if (m_source == null)
+                    throw new InvalidOperationException("This track is not a local track.");
+                return m_source.StaticFrameCount;
+            }
+        }
+
+        /// <summary>
+        /// The number of received frames which were never rendered to the texture.
+        /// </summary>
+        public ulong DroppedFrameCount
+        {
+            get
+            {
+                if (m_renderer == null)
+                    throw new InvalidOperationException("This track is not a remote track.");
+                return m_renderer.DroppedFrameCount;
+            }
+        }
+
+        /// <summary>
+        /// The statistics of the presentation of the received frames at their render time.
+        /// </summary>
+        public VideoRenderStats RenderStats
+        {
+            get
+            {
+                if (m_renderer == null)
+                    throw new InvalidOperationException("This track is not a remote track.");
+                return m_renderer.RenderStats;
+            }
+        }
+
+        /// <summary>
+        /// The statistics of the pacing of the frame capture.
+        /// </summary>
+        public VideoCaptureStats CaptureStats
+        {
+            get
+            {
+                if (m_source == null)
+                    throw new InvalidOperationException("This track is not a local track.");
+                return m_source.CaptureStats;
+            }
+        }
+
         internal void OnVideoFrameResize(Texture texture)
         {
             OnVideoReceived?.Invoke(texture);
@@ -241,6 +408,8 @@ namespace Unity.WebRTC
             public int width;
             public int height;
             public GraphicsFormat format;
+            public int dataSize;
+            public int stride;
 
             public EncodeData(Texture texture, IntPtr ptrSource)
             {
@@ -249,9 +418,39 @@ namespace Unity.WebRTC
                 width = texture.width;
                 height = texture.height;
                 format = texture.graphicsFormat;
+                dataSize = 0;
+                stride = 0;
+            }
+
+            // The pixels on CPU memory which are passed instead of the texture without graphics device.
+            public unsafe EncodeData(Texture2D texture, IntPtr ptrSource)
+            {
+                var data = texture.GetRawTextureData<byte>();
+                ptrTexture = new IntPtr(data.GetUnsafeReadOnlyPtr());
+                ptrTrackSource = ptrSource;
+                width = texture.width;
+                height = texture.height;
+                format = texture.graphicsFormat;
+                dataSize = data.Length;
+                stride = texture.width * 4;
             }
         }
 
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct PrewarmBuffersData
+        {
+            public IntPtr ptrTrackSource;
+            public int width;
+            public int height;
+            public GraphicsFormat format;
+            public int count;
+            // Set by the rendering thread when the event has finished reading the data.
+            public int consumed;
+        }
+
+        static readonly int s_prewarmConsumedOffset =
+            Marshal.OffsetOf(typeof(PrewarmBuffersData), "consumed").ToInt32();
+
         // Blit parameter to flip vertically
         static Vector2 s_scale = new Vector2(1f, -1f);
         static Vector2 s_offset = new Vector2(0, 1f);
@@ -261,6 +460,9 @@ namespace Unity.WebRTC
         internal RenderTexture destTexture_;
 
         IntPtr ptr_ = IntPtr.Zero;
+        // The data of the issued prewarm events. Each block is reused only after
+        // the rendering thread has consumed its event.
+        readonly List<IntPtr> prewarmPtrs_ = new List<IntPtr>();
         EncodeData data_;
         Texture prevTexture_;
 
@@ -278,6 +480,17 @@ namespace Unity.WebRTC
 
         public void Update()
         {
+            if (SystemInfo.graphicsDeviceType == UnityEngine.Rendering.GraphicsDeviceType.Null)
+            {
+                // The pixels are sent as they are without the flip. The data pointer may change when
+                // the texture is modified, so it is taken every frame.
+                data_ = new EncodeData((Texture2D)sourceTexture_, self);
+                Marshal.StructureToPtr(data_, ptr_, true);
+                prevTexture_ = null;
+                WebRTC.Context.Encode(ptr_);
+                return;
+            }
+
             // [Note-kazuki: 2020-03-09] Flip vertically RenderTexture
             // note: streamed video is flipped vertical if no action was taken:
             //  - duplicate RenderTexture from its source texture
@@ -303,6 +516,54 @@ namespace Unity.WebRTC
             WebRTC.Context.Encode(ptr_);
         }
 
+        public void SetBufferPoolLimits(int maxBufferCount, TimeSpan staleFrameLimit)
+        {
+            NativeMethods.VideoTrackSourceSetBufferPoolLimits(
+                self, maxBufferCount, (long)staleFrameLimit.TotalMilliseconds);
+        }
+
+        public ulong OverwrittenFrameCount => NativeMethods.VideoTrackSourceGetOverwrittenFrameCount(self);
+
+        public ulong StaticFrameCount => NativeMethods.VideoTrackSourceGetStaticFrameCount(self);
+
+        public VideoCaptureStats CaptureStats
+        {
+            get
+            {
+                NativeMethods.VideoTrackSourceGetSchedulerStats(self, out var stats);
+                return stats;
+            }
+        }
+
+        IntPtr AcquirePrewarmBuffer()
+        {
+            Thread.MemoryBarrier();
+            foreach (var ptr in prewarmPtrs_)
+            {
+                if (Marshal.ReadInt32(ptr, s_prewarmConsumedOffset) != 0)
+                    return ptr;
+            }
+            var newPtr = Marshal.AllocHGlobal(Marshal.SizeOf(typeof(PrewarmBuffersData)));
+            prewarmPtrs_.Add(newPtr);
+            return newPtr;
+        }
+
+        public void PrewarmBuffers(int count)
+        {
+            var ptr = AcquirePrewarmBuffer();
+            var data = new PrewarmBuffersData
+            {
+                ptrTrackSource = self,
+                width = destTexture_.width,
+                height = destTexture_.height,
+                format = destTexture_.graphicsFormat,
+                count = count,
+                consumed = 0
+            };
+            Marshal.StructureToPtr(data, ptr, false);
+            WebRTC.Context.PrewarmBuffers(ptr);
+        }
+
         public override void Dispose()
         {
             if (this.disposed)
@@ -327,6 +588,17 @@ namespace Unity.WebRTC
                 }, 0.1f);
             }
 
+            if (prewarmPtrs_.Count > 0)
+            {
+                var prewarmPtrs = prewarmPtrs_.ToArray();
+                prewarmPtrs_.Clear();
+                WebRTC.DelayActionOnMainThread(() =>
+                {
+                    foreach (var ptr in prewarmPtrs)
+                        Marshal.FreeHGlobal(ptr);
+                }, 0.1f);
+            }
+
             if (self != IntPtr.Zero && !WebRTC.Context.IsNull)
             {
                 WebRTC.Table.Remove(self);
@@ -341,6 +613,16 @@ namespace Unity.WebRTC
         private VideoStreamTrack track;
 
         internal uint id => NativeMethods.GetVideoRendererId(self);
+        internal ulong DroppedFrameCount => NativeMethods.GetVideoRendererDroppedFrameCount(self);
+
+        internal VideoRenderStats RenderStats
+        {
+            get
+            {
+                NativeMethods.GetVideoRendererStats(self, out var stats);
+                return stats;
+            }
+        }
         private bool disposed;
 
         public Texture Texture { get; private set; }
@@ -644,6 +644,7 @@ namespace Unity.WebRTC
 #endif
         private static Context s_context = null;
         private static SynchronizationContext s_syncContext;
+        private static readonly List<UnityVideoRenderer> s_receiveRenderers = new List<UnityVideoRenderer>();
 
         /// <summary>
         ///
@@ -700,13 +701,16 @@ namespace Unity.WebRTC
                 {
                     var tempTextureActive = RenderTexture.active;
                     RenderTexture.active = null;
+                    s_receiveRenderers.Clear();
                     foreach (var reference in VideoStreamTrack.s_tracks.Values)
                     {
                         if (!reference.TryGetTarget(out var track))
                             continue;
                         track.UpdateSendTexture();
-                        track.UpdateReceiveTexture();
+                        track.CollectReceiveRenderer(s_receiveRenderers);
                     }
+                    // The frames of all receivers are converted in one event.
+                    Context.UpdateRendererTextures(s_receiveRenderers);
                     RenderTexture.active = tempTextureActive;
                 }
             }
@@ -741,6 +745,17 @@ namespace Unity.WebRTC
             set { s_context.limitTextureSize = value; }
         }
 
+        /// <summary>
+        /// The statistics of the 10 ms tick which pulls the received audio from WebRTC.
+        /// </summary>
+        /// <returns></returns>
+        public static AudioTickStats GetAudioTickStats()
+        {
+            if (s_context == null)
+                throw new InvalidOperationException("WebRTC is not initialized.");
+            return s_context.GetAudioTickStats();
+        }
+
         /// <summary>
         ///
         /// </summary>
@@ -1443,6 +1458,8 @@ namespace Unity.WebRTC
         [DllImport(WebRTC.Lib)]
         public static extern void ContextDeleteAudioTrackSink(IntPtr context, IntPtr sink);
         [DllImport(WebRTC.Lib)]
+        public static extern void ContextGetAudioTickStats(IntPtr context, out AudioTickStats stats);
+        [DllImport(WebRTC.Lib)]
         public static extern void AudioTrackAddSink(IntPtr track, IntPtr sink);
         [DllImport(WebRTC.Lib)]
         public static extern void AudioTrackRemoveSink(IntPtr track, IntPtr sink);
@@ -1450,6 +1467,10 @@ namespace Unity.WebRTC
         public static extern void AudioTrackSinkProcessAudio(
             IntPtr sink, float[] data, int length, int channels, int sampleRate);
         [DllImport(WebRTC.Lib)]
+        public static extern void AudioTrackSinkGetStats(IntPtr sink, out AudioPlayoutStats stats);
+        [DllImport(WebRTC.Lib)]
+        public static extern void AudioTrackSinkSetTargetLatency(IntPtr sink, int milliseconds);
+        [DllImport(WebRTC.Lib)]
         [return: MarshalAs(UnmanagedType.U1)]
         public static extern bool MediaStreamAddTrack(IntPtr stream, IntPtr track);
         [DllImport(WebRTC.Lib)]
@@ -1482,6 +1503,10 @@ namespace Unity.WebRTC
         [DllImport(WebRTC.Lib)]
         public static extern uint GetVideoRendererId(IntPtr sink);
         [DllImport(WebRTC.Lib)]
+        public static extern ulong GetVideoRendererDroppedFrameCount(IntPtr sink);
+        [DllImport(WebRTC.Lib)]
+        public static extern void GetVideoRendererStats(IntPtr sink, out VideoRenderStats stats);
+        [DllImport(WebRTC.Lib)]
         public static extern void DeleteVideoRenderer(IntPtr context, IntPtr sink);
         [DllImport(WebRTC.Lib)]
         public static extern void VideoTrackAddOrUpdateSink(IntPtr track, IntPtr sink);
@@ -1498,8 +1523,24 @@ namespace Unity.WebRTC
         [DllImport(WebRTC.Lib)]
         public static extern int GetReleaseBuffersEventID();
         [DllImport(WebRTC.Lib)]
+        public static extern IntPtr GetPrewarmBuffersFunc(IntPtr context);
+        [DllImport(WebRTC.Lib)]
+        public static extern int GetPrewarmBuffersEventID();
+        [DllImport(WebRTC.Lib)]
+        public static extern void VideoTrackSourceSetBufferPoolLimits(IntPtr source, int maxBufferCount, long staleFrameLimitMs);
+        [DllImport(WebRTC.Lib)]
+        public static extern ulong VideoTrackSourceGetOverwrittenFrameCount(IntPtr source);
+        [DllImport(WebRTC.Lib)]
+        public static extern ulong VideoTrackSourceGetStaticFrameCount(IntPtr source);
+        [DllImport(WebRTC.Lib)]
+        public static extern void VideoTrackSourceGetSchedulerStats(IntPtr source, out VideoCaptureStats stats);
+        [DllImport(WebRTC.Lib)]
         public static extern IntPtr GetUpdateTextureFunc(IntPtr context);
         [DllImport(WebRTC.Lib)]
+        public static extern IntPtr GetBatchUpdateTexturesFunc(IntPtr context);
+        [DllImport(WebRTC.Lib)]
+        public static extern int GetBatchUpdateTexturesEventID();
+        [DllImport(WebRTC.Lib)]
         public static extern void AudioSourceProcessLocalAudio(IntPtr source, IntPtr array, int sampleRate, int channels, int frames);
         [DllImport(WebRTC.Lib)]
         public static extern IntPtr StatsGetJson(IntPtr stats);
@@ -1606,5 +1647,117 @@ namespace Unity.WebRTC
             Graphics.ExecuteCommandBuffer(_command);
             _command.Clear();
         }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct TextureUpdateData
+        {
+            public uint rendererId;
+            public int width;
+            public int height;
+            public GraphicsFormat format;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct BatchUpdateTexturesData
+        {
+            public IntPtr textures;
+            public int count;
+            // Set by the rendering thread when the event has finished reading the data.
+            public int consumed;
+        }
+
+        // The data of one issued event. The rendering thread reads it asynchronously,
+        // so the buffer is reused only after the event has consumed it.
+        class BatchBuffer
+        {
+            public IntPtr batch;
+            public IntPtr textures;
+            public int capacity;
+        }
+
+        // The rendering thread runs a few frames behind at most.
+        const int MaxBatchBuffers = 8;
+        static readonly List<BatchBuffer> s_batchBuffers = new List<BatchBuffer>();
+        static readonly int s_consumedOffset =
+            Marshal.OffsetOf(typeof(BatchUpdateTexturesData), "consumed").ToInt32();
+
+        static BatchBuffer AcquireBatchBuffer()
+        {
+            Thread.MemoryBarrier();
+            foreach (var buffer in s_batchBuffers)
+            {
+                if (Marshal.ReadInt32(buffer.batch, s_consumedOffset) != 0)
+                    return buffer;
+            }
+            if (s_batchBuffers.Count >= MaxBatchBuffers)
+                return null;
+            var newBuffer = new BatchBuffer
+            {
+                batch = Marshal.AllocHGlobal(Marshal.SizeOf(typeof(BatchUpdateTexturesData)))
+            };
+            s_batchBuffers.Add(newBuffer);
+            return newBuffer;
+        }
+
+        /// <summary>
+        /// Converts the frames of all renderers in parallel with one event,
+        /// then updates the textures with the converted data.
+        /// </summary>
+        public static void UpdateRendererTextures(
+            IntPtr batchCallback, int batchEventID, IntPtr callback, IReadOnlyList<UnityVideoRenderer> renderers)
+        {
+#if !UNITY_2020_1_OR_NEWER
+            if (SystemInfo.graphicsDeviceType == GraphicsDeviceType.Direct3D12)
+            {
+                throw new NotSupportedException(
+                    "CommandBuffer.IssuePluginCustomTextureUpdateV2 method is not supported " +
+                    "when using Direct3D12 on Unity2019 or older.");
+            }
+#endif
+            if (renderers.Count == 0)
+                return;
+
+            // When the rendering thread has not consumed the previous events, the
+            // texture update events convert the frames one by one instead.
+            var buffer = AcquireBatchBuffer();
+            if (buffer != null)
+            {
+                int size = Marshal.SizeOf(typeof(TextureUpdateData));
+                if (buffer.capacity < renderers.Count)
+                {
+                    // No event refers to this buffer, so it can be freed now.
+                    if (buffer.textures != IntPtr.Zero)
+                        Marshal.FreeHGlobal(buffer.textures);
+                    buffer.capacity = Math.Max(renderers.Count, buffer.capacity * 2);
+                    buffer.textures = Marshal.AllocHGlobal(size * buffer.capacity);
+                }
+
+                for (int i = 0; i < renderers.Count; i++)
+                {
+                    var texture = renderers[i].Texture;
+                    var data = new TextureUpdateData
+                    {
+                        rendererId = renderers[i].id,
+                        width = texture.width,
+                        height = texture.height,
+                        format = texture.graphicsFormat
+                    };
+                    Marshal.StructureToPtr(data, buffer.textures + size * i, false);
+                }
+                var batch = new BatchUpdateTexturesData
+                {
+                    textures = buffer.textures,
+                    count = renderers.Count,
+                    consumed = 0
+                };
+                Marshal.StructureToPtr(batch, buffer.batch, false);
+
+                _command.IssuePluginEventAndData(batchCallback, batchEventID, buffer.batch);
+            }
+            for (int i = 0; i < renderers.Count; i++)
+                _command.IssuePluginCustomTextureUpdateV2(callback, renderers[i].Texture, renderers[i].id);
+            Graphics.ExecuteCommandBuffer(_command);
+            _command.Clear();
+        }
     }
 }